@@ -0,0 +1,366 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+
+/* veretino-bench-hash: the throughput of the hashing core
+ * for each algorithm, read size and number of threads.
+ *
+ * memory: the data is hashed from a buffer (the hash functions only);
+ * warm:   the file is hashed by the Hasher::calculate, its data is in the page cache;
+ * cold:   the same, the file data is dropped from the page cache before each run (Linux).
+ *
+ * The test file is created in the --dir (should be on the storage being measured) unless --file is set.
+ * The results are printed to stdout as JSON (default) or CSV.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QRandomGenerator>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QThread>
+#include <QDir>
+#include <QFileInfo>
+#include "hasher.h"
+#include "hashfunction.h"
+#include "algostring.h"
+#include "cpufeatures.h"
+#include "tools.h"
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Record {
+    QString mode;
+    QString algo;
+    int chunk = 0;
+    int threads = 1;
+    qint64 bytes = 0;
+    qint64 nsecs = 0;
+    QString engine; // HashFunction::engineName
+
+    double mibPerSec() const { return nsecs > 0 ? (double(bytes) / 1048576) / (double(nsecs) / 1e9) : 0; }
+}; // struct Record
+
+const QList<QCryptographicHash::Algorithm> l_algos { QCryptographicHash::Md5,
+                                                     QCryptographicHash::Sha1,
+                                                     QCryptographicHash::Sha256,
+                                                     QCryptographicHash::Sha512,
+                                                     Algo::Blake3,
+                                                     Algo::Crc32c };
+
+// "4K", "1M" --> bytes
+qint64 parseSize(const QString &str)
+{
+    const QString s = str.trimmed().toUpper();
+    qint64 factor = 1;
+    QString num = s;
+
+    if (s.endsWith('K'))
+        factor = 1024;
+    else if (s.endsWith('M'))
+        factor = 1048576;
+    else if (s.endsWith('G'))
+        factor = 1073741824;
+
+    if (factor > 1)
+        num.chop(1);
+
+    bool ok = false;
+    const qint64 value = num.toLongLong(&ok);
+    return ok ? value * factor : -1;
+}
+
+QList<int> parseInts(const QString &str, bool isSize)
+{
+    QList<int> res;
+
+    for (const QString &item : str.split(',', Qt::SkipEmptyParts)) {
+        const qint64 value = isSize ? parseSize(item) : item.trimmed().toLongLong();
+        if (value > 0 && value <= INT_MAX)
+            res << static_cast<int>(value);
+    }
+
+    return res;
+}
+
+bool dropCache(const QString &filePath)
+{
+#if defined(Q_OS_LINUX)
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    const bool res = (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+    ::close(fd);
+    return res;
+#else
+    Q_UNUSED(filePath)
+    return false;
+#endif
+}
+
+bool createTestFile(QTemporaryFile &file, qint64 size)
+{
+    if (!file.open())
+        return false;
+
+    QByteArray block(1048576, Qt::Uninitialized);
+    QRandomGenerator *gen = QRandomGenerator::global();
+
+    for (qint64 written = 0; written < size;) {
+        gen->fillRange(reinterpret_cast<quint32*>(block.data()), block.size() / sizeof(quint32));
+        const qint64 len = qMin<qint64>(block.size(), size - written);
+
+        if (file.write(block.constData(), len) != len)
+            return false;
+
+        written += len;
+    }
+
+    file.flush();
+    return true;
+}
+
+Record benchMemory(const QByteArray &data, QCryptographicHash::Algorithm algo, int chunk, int threads)
+{
+    HashFunction hash(algo);
+    hash.setThreads(threads);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (qsizetype pos = 0; pos < data.size(); pos += chunk)
+        hash.addData(data.constData() + pos, qMin<qsizetype>(chunk, data.size() - pos));
+
+    hash.result();
+
+    return { QStringLiteral(u"memory"), AlgoString::name(algo), chunk, threads, data.size(), timer.nsecsElapsed(),
+             HashFunction::engineName(algo) };
+}
+
+Record benchFile(const QString &filePath, bool cold, QCryptographicHash::Algorithm algo, int chunk, int threads,
+                 const Hasher::ReadOptions &baseOptions)
+{
+    Hasher::ReadOptions options = baseOptions;
+    options.chunk = chunk;
+
+    Hasher hasher(algo);
+    hasher.setThreads(threads);
+    hasher.setReadOptions(options);
+
+    if (cold)
+        dropCache(filePath);
+    else
+        hasher.calculate(filePath); // warming up
+
+    QElapsedTimer timer;
+    timer.start();
+    hasher.calculate(filePath);
+
+    return { cold ? QStringLiteral(u"cold") : QStringLiteral(u"warm"), AlgoString::name(algo),
+             chunk, threads, QFileInfo(filePath).size(), timer.nsecsElapsed(), HashFunction::engineName(algo) };
+}
+
+QString kernelInfo()
+{
+    const CpuFeatures &cpu = CpuFeatures::current();
+    QStringList res;
+
+    if (cpu.sse41)
+        res << QStringLiteral(u"sse4.1");
+    if (cpu.sse42)
+        res << QStringLiteral(u"sse4.2");
+    if (cpu.avx2)
+        res << QStringLiteral(u"avx2");
+    if (cpu.avx512)
+        res << QStringLiteral(u"avx512f");
+    if (cpu.shaNi)
+        res << QStringLiteral(u"sha");
+    if (cpu.armSha)
+        res << QStringLiteral(u"armv8-sha");
+    if (cpu.armCrc32)
+        res << QStringLiteral(u"armv8-crc");
+
+    return res.isEmpty() ? QStringLiteral(u"portable") : res.join(',');
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral(u"veretino-bench-hash"));
+    QCoreApplication::setApplicationVersion(APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(u"Hashing throughput benchmark of " APP_NAME_VERSION));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption optAlgos(QStringLiteral(u"algos"), QStringLiteral(u"Algorithms (md5,sha1,sha256,sha512,blake3,crc32c)."),
+                                      QStringLiteral(u"list"), QStringLiteral(u"md5,sha1,sha256,sha512,blake3,crc32c"));
+    const QCommandLineOption optChunks(QStringLiteral(u"chunks"), QStringLiteral(u"Read sizes."),
+                                       QStringLiteral(u"list"), QStringLiteral(u"4K,16K,64K,256K,1M,4M,16M"));
+    const QCommandLineOption optThreads(QStringLiteral(u"threads"), QStringLiteral(u"Threads per file (BLAKE3 only; 1 for the others)."),
+                                        QStringLiteral(u"list"), QStringLiteral(u"1,") + QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption optModes(QStringLiteral(u"modes"), QStringLiteral(u"memory,warm,cold."),
+                                      QStringLiteral(u"list"), QStringLiteral(u"memory,warm,cold"));
+    const QCommandLineOption optSize(QStringLiteral(u"size"), QStringLiteral(u"Data size of the buffer and test file."),
+                                     QStringLiteral(u"size"), QStringLiteral(u"256M"));
+    const QCommandLineOption optFile(QStringLiteral(u"file"), QStringLiteral(u"An existing file to hash instead of the test one."),
+                                     QStringLiteral(u"path"));
+    const QCommandLineOption optDir(QStringLiteral(u"dir"), QStringLiteral(u"The folder to create the test file in."),
+                                    QStringLiteral(u"path"), QDir::tempPath());
+    const QCommandLineOption optMmap(QStringLiteral(u"mmap"), QStringLiteral(u"Memory-mapped reading of large files."));
+    const QCommandLineOption optQueueDepth(QStringLiteral(u"queue-depth"), QStringLiteral(u"io_uring reads in flight (> 1)."),
+                                           QStringLiteral(u"number"), QStringLiteral(u"0"));
+    const QCommandLineOption optRepeat(QStringLiteral(u"repeat"), QStringLiteral(u"Runs of each case, the best one is reported."),
+                                       QStringLiteral(u"number"), QStringLiteral(u"3"));
+    const QCommandLineOption optFormat(QStringLiteral(u"format"), QStringLiteral(u"json or csv."),
+                                       QStringLiteral(u"format"), QStringLiteral(u"json"));
+
+    parser.addOptions({ optAlgos, optChunks, optThreads, optModes, optSize, optFile, optDir,
+                        optMmap, optQueueDepth, optRepeat, optFormat });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QList<QCryptographicHash::Algorithm> algos;
+    for (const QString &name : parser.value(optAlgos).split(',', Qt::SkipEmptyParts)) {
+        const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(name.trimmed());
+        if (l_algos.contains(algo) && !algos.contains(algo))
+            algos << algo;
+        else
+            err << "Unknown algorithm: " << name << Qt::endl;
+    }
+
+    const QList<int> chunks = parseInts(parser.value(optChunks), true);
+    const QList<int> threadCounts = parseInts(parser.value(optThreads), false);
+    const QStringList modes = parser.value(optModes).split(',', Qt::SkipEmptyParts);
+    const qint64 dataSize = parseSize(parser.value(optSize));
+    const int repeat = qMax(1, parser.value(optRepeat).toInt());
+    const bool isCsv = (parser.value(optFormat).compare(QStringLiteral(u"csv"), Qt::CaseInsensitive) == 0);
+
+    if (algos.isEmpty() || chunks.isEmpty() || threadCounts.isEmpty() || dataSize <= 0) {
+        err << "Nothing to measure" << Qt::endl;
+        return 1;
+    }
+
+    Hasher::ReadOptions readOptions;
+    readOptions.mapped = parser.isSet(optMmap);
+    readOptions.queueDepth = parser.value(optQueueDepth).toInt();
+
+    // the data
+    QByteArray buffer;
+    if (modes.contains(QStringLiteral(u"memory"))) {
+        buffer.resize(dataSize);
+        QRandomGenerator::global()->fillRange(reinterpret_cast<quint32*>(buffer.data()), buffer.size() / sizeof(quint32));
+    }
+
+    QString filePath = parser.value(optFile);
+    QTemporaryFile testFile(QDir(parser.value(optDir)).filePath(QStringLiteral(u"veretino-bench-XXXXXX")));
+    const bool hasFileModes = modes.contains(QStringLiteral(u"warm")) || modes.contains(QStringLiteral(u"cold"));
+
+    if (hasFileModes && filePath.isEmpty()) {
+        if (!createTestFile(testFile, dataSize)) {
+            err << "Can't create the test file in: " << parser.value(optDir) << Qt::endl;
+            return 1;
+        }
+        filePath = testFile.fileName();
+    }
+
+    if (modes.contains(QStringLiteral(u"cold")) && !dropCache(filePath))
+        err << "The page cache can't be dropped here, the 'cold' results are not reliable" << Qt::endl;
+
+    // the measuring
+    QList<Record> records;
+
+    for (const QString &mode : modes) {
+        for (const QCryptographicHash::Algorithm algo : std::as_const(algos)) {
+            for (const int threads : threadCounts) {
+                // the threads are used by the BLAKE3 only
+                if (threads > 1 && algo != Algo::Blake3)
+                    continue;
+
+                for (const int chunk : chunks) {
+                    Record best;
+
+                    for (int i = 0; i < repeat; ++i) {
+                        Record rec;
+
+                        try {
+                            if (mode == QStringLiteral(u"memory"))
+                                rec = benchMemory(buffer, algo, chunk, threads);
+                            else if (mode == QStringLiteral(u"warm") || mode == QStringLiteral(u"cold"))
+                                rec = benchFile(filePath, mode == QStringLiteral(u"cold"), algo, chunk, threads, readOptions);
+                            else
+                                break;
+                        }
+                        catch (const Exception &e) {
+                            err << "Error " << e.errorCode << ": " << e.what() << Qt::endl;
+                            return 1;
+                        }
+
+                        if (best.nsecs == 0 || rec.nsecs < best.nsecs)
+                            best = rec;
+                    }
+
+                    if (best.nsecs > 0) {
+                        records << best;
+                        err << best.mode << ' ' << best.algo << ' ' << best.chunk << ' ' << best.threads
+                            << ": " << QString::number(best.mibPerSec(), 'f', 1) << " MiB/s" << Qt::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    // the results
+    if (isCsv) {
+        out << "mode,algorithm,chunk,threads,bytes,nsecs,mib_per_sec,engine" << Qt::endl;
+
+        for (const Record &rec : std::as_const(records)) {
+            out << rec.mode << ',' << rec.algo << ',' << rec.chunk << ',' << rec.threads << ','
+                << rec.bytes << ',' << rec.nsecs << ',' << QString::number(rec.mibPerSec(), 'f', 2) << ','
+                << rec.engine << Qt::endl;
+        }
+    } else {
+        QJsonArray results;
+
+        for (const Record &rec : std::as_const(records)) {
+            results.append(QJsonObject { { "mode", rec.mode },
+                                        { "algorithm", rec.algo },
+                                        { "chunk", rec.chunk },
+                                        { "threads", rec.threads },
+                                        { "bytes", rec.bytes },
+                                        { "nsecs", rec.nsecs },
+                                        { "mib_per_sec", rec.mibPerSec() },
+                                        { "engine", rec.engine } });
+        }
+
+        const QJsonObject root { { "version", APP_VERSION },
+                                 { "cpu", kernelInfo() },
+                                 { "ideal_threads", QThread::idealThreadCount() },
+                                 { "file", hasFileModes ? filePath : QString() },
+                                 { "mmap", readOptions.mapped },
+                                 { "queue_depth", readOptions.queueDepth },
+                                 { "results", results } };
+
+        out << QJsonDocument(root).toJson();
+    }
+
+    return 0;
+}
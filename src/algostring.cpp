@@ -10,7 +10,8 @@ const QStringList AlgoString::sl_digest_exts = {
     QStringLiteral(u"md5"),
     QStringLiteral(u"sha1"),
     QStringLiteral(u"sha256"),
-    QStringLiteral(u"sha512")
+    QStringLiteral(u"sha512"),
+    QStringLiteral(u"blake3")
 };
 
 AlgoString::AlgoString(QCryptographicHash::Algorithm algo)
@@ -42,6 +43,10 @@ QString AlgoString::name(QCryptographicHash::Algorithm algo)
         return QStringLiteral(u"SHA-256");
     case QCryptographicHash::Sha512:
         return QStringLiteral(u"SHA-512");
+    case Algo::Blake3:
+        return QStringLiteral(u"BLAKE3");
+    case Algo::Crc32c:
+        return QStringLiteral(u"CRC32C");
     default:
         return "Unknown";
     }
@@ -68,6 +73,10 @@ QString AlgoString::suffix(QCryptographicHash::Algorithm algo)
         return sl_digest_exts.at(2);
     case QCryptographicHash::Sha512:
         return sl_digest_exts.at(3);
+    case Algo::Blake3:
+        return sl_digest_exts.at(4);
+    case Algo::Crc32c:
+        return QStringLiteral(u"crc32c"); // a database digest only, no digest files
     default:
         return {};
     }
@@ -96,9 +105,12 @@ int AlgoString::digestLength(QCryptographicHash::Algorithm algo)
     case QCryptographicHash::Sha1:
         return 40;
     case QCryptographicHash::Sha256:
+    case Algo::Blake3:
         return 64;
     case QCryptographicHash::Sha512:
         return 128;
+    case Algo::Crc32c:
+        return 8;
     default:
         return 0;
     }
@@ -107,6 +119,8 @@ int AlgoString::digestLength(QCryptographicHash::Algorithm algo)
 QCryptographicHash::Algorithm AlgoString::algoByStrLen(int digestLength)
 {
     switch (digestLength) {
+    case 8:
+        return Algo::Crc32c;
     case 32:
         return QCryptographicHash::Md5;
     case 40:
@@ -122,9 +136,18 @@ QCryptographicHash::Algorithm AlgoString::algoByStrLen(int digestLength)
 
 QCryptographicHash::Algorithm AlgoString::strToAlgo(const QString &strAlgo)
 {
+    // the names whose digits are not of the SHA/MD ones, matched in full: "sha3" or "crc32" are not these
+    const QString str = strAlgo.trimmed();
+
+    if (str.compare(name(Algo::Blake3), Qt::CaseInsensitive) == 0)
+        return Algo::Blake3;
+
+    if (str.compare(name(Algo::Crc32c), Qt::CaseInsensitive) == 0)
+        return Algo::Crc32c;
+
     QList<int> digits;
 
-    for (QChar ch : strAlgo) {
+    for (QChar ch : str) {
         if (ch.isDigit())
             digits.append(ch.digitValue());
     }
@@ -9,6 +9,14 @@
 #include <QStringList>
 #include <QCryptographicHash>
 
+// algorithms not provided by QCryptographicHash, with ids outside its range
+namespace Algo {
+constexpr QCryptographicHash::Algorithm Blake3 = static_cast<QCryptographicHash::Algorithm>(28);
+
+// non-cryptographic: the fast verification tier of a multi-digest database (accidental changes only)
+constexpr QCryptographicHash::Algorithm Crc32c = static_cast<QCryptographicHash::Algorithm>(29);
+} // namespace Algo
+
 class AlgoString
 {
 public:
@@ -17,27 +25,28 @@ public:
 
     QCryptographicHash::Algorithm algorithm() const;
 
-    // "MD5", "SHA-1", "SHA-256", "SHA-512"
+    // "MD5", "SHA-1", "SHA-256", "SHA-512", "BLAKE3", "CRC32C"
     QString name() const;
     static QString name(QCryptographicHash::Algorithm algo);
     static QString name(int digestLength);
 
-    // "md5", "sha1", "sha256", "sha512"
+    // "md5", "sha1", "sha256", "sha512", "blake3", "crc32c"
     QString suffix() const;
     static QString suffix(QCryptographicHash::Algorithm algo);
     static QString suffix(int digestLength);
 
-    // <filePath> ends with suffix ("md5", "sha1", "sha256", "sha512")
+    // <filePath> ends with suffix ("md5", "sha1", "sha256", "sha512", "blake3")
     static bool isDigestFile(const QString &filePath);
 
-    // returns the checksum str length: sha(1) = 40, sha(256) = 64, sha(512) = 128
+    // returns the checksum str length: sha(1) = 40, sha(256) = 64, sha(512) = 128, blake3 = 64, crc32c = 8
     int digestLength() const;
     static int digestLength(QCryptographicHash::Algorithm algo);
 
-    // 64 -> QCryptographicHash::Sha256
+    // 64 -> QCryptographicHash::Sha256 (BLAKE3 digests of the same length are recognized by name only), 8 -> Algo::Crc32c
     static QCryptographicHash::Algorithm algoByStrLen(int digestLength);
 
-    // "SHA-256" -> QCryptographicHash::Sha256
+    // "SHA-256" -> QCryptographicHash::Sha256, "BLAKE3" -> Algo::Blake3, "CRC32C" -> Algo::Crc32c (case-insensitive);
+    // 0 if unknown, e.g. "sha3", "crc32"
     static QCryptographicHash::Algorithm strToAlgo(const QString &strAlgo);
 
     static const QStringList sl_digest_exts;
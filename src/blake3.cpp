@@ -0,0 +1,408 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "blake3.h"
+#include "blake3_p.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace blake3;
+
+namespace {
+// subtrees of at least this number of chunks (256 KiB) are worth passing to another thread
+constexpr uint64_t k_minParallelChunks = 256;
+
+// the largest number of chunks hashed by the kernels at once
+constexpr uint64_t k_maxBatchChunks = 64;
+
+inline uint32_t rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t loadLe(const uint8_t *p)
+{
+    return static_cast<uint32_t>(p[0])
+           | (static_cast<uint32_t>(p[1]) << 8)
+           | (static_cast<uint32_t>(p[2]) << 16)
+           | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void storeLe(uint8_t *p, uint32_t x)
+{
+    p[0] = static_cast<uint8_t>(x);
+    p[1] = static_cast<uint8_t>(x >> 8);
+    p[2] = static_cast<uint8_t>(x >> 16);
+    p[3] = static_cast<uint8_t>(x >> 24);
+}
+
+inline void gPortable(uint32_t v[16], int a, int b, int c, int d, uint32_t mx, uint32_t my)
+{
+    v[a] = v[a] + v[b] + mx;
+    v[d] = rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + my;
+    v[d] = rotr(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 7);
+}
+
+// the full 16-word output of the compression function
+void compress(const uint32_t cv[8], const uint32_t m[16],
+              uint32_t blockLen, uint64_t counter, uint32_t flags, uint32_t out[16])
+{
+    uint32_t v[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        k_iv[0], k_iv[1], k_iv[2], k_iv[3],
+        static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), blockLen, flags
+    };
+
+    for (int r = 0; r < 7; ++r) {
+        const uint8_t *s = k_msgSchedule[r];
+
+        gPortable(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        gPortable(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        gPortable(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        gPortable(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+
+        gPortable(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        gPortable(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        gPortable(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        gPortable(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        out[i] = v[i] ^ v[i + 8];
+        out[i + 8] = v[i + 8] ^ cv[i];
+    }
+}
+
+void compressBlock(const uint32_t cv[8], const uint8_t block[64],
+                   uint32_t blockLen, uint64_t counter, uint32_t flags, uint32_t out[16])
+{
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i)
+        m[i] = loadLe(block + i * 4);
+
+    compress(cv, m, blockLen, counter, flags, out);
+}
+
+void parentCv(const uint32_t left[8], const uint32_t right[8], uint32_t out[8])
+{
+    uint32_t m[16];
+    std::memcpy(m, left, 32);
+    std::memcpy(m + 8, right, 32);
+
+    uint32_t res[16];
+    compress(k_iv, m, 64, 0, Parent, res);
+    std::memcpy(out, res, 32);
+}
+
+void hashChunkPortable(const uint8_t *input, uint64_t counter, uint32_t out[8])
+{
+    uint32_t cv[8];
+    std::memcpy(cv, k_iv, 32);
+
+    for (size_t block = 0; block < k_blocksPerChunk; ++block) {
+        uint32_t flags = 0;
+        if (block == 0)
+            flags |= ChunkStart;
+        if (block == k_blocksPerChunk - 1)
+            flags |= ChunkEnd;
+
+        uint32_t res[16];
+        compressBlock(cv, input + block * 64, 64, counter, flags, res);
+        std::memcpy(cv, res, 32);
+    }
+
+    std::memcpy(out, cv, 32);
+}
+
+// hashes 'number' full chunks with the widest available kernel
+void hashChunks(const uint8_t *input, uint64_t number, uint64_t counter, uint32_t *out)
+{
+#ifdef VER_ARCH_X86
+    const CpuFeatures &cpu = CpuFeatures::current();
+
+    if (cpu.avx512) {
+        for (; number >= 16; number -= 16, counter += 16, input += 16 * k_chunkLen, out += 16 * 8)
+            hashChunksAvx512(input, counter, out);
+    }
+
+    if (cpu.avx2) {
+        for (; number >= 8; number -= 8, counter += 8, input += 8 * k_chunkLen, out += 8 * 8)
+            hashChunksAvx2(input, counter, out);
+    }
+
+    if (cpu.sse41) {
+        for (; number >= 4; number -= 4, counter += 4, input += 4 * k_chunkLen, out += 4 * 8)
+            hashChunksSse41(input, counter, out);
+    }
+#endif
+
+    for (; number > 0; --number, ++counter, input += k_chunkLen, out += 8)
+        hashChunkPortable(input, counter, out);
+}
+
+// the (non-root) chaining value of the complete subtree of 'chunks' (power of 2) full chunks
+void subtreeCv(const uint8_t *input, uint64_t chunks, uint64_t counter, int threads, uint32_t out[8])
+{
+    if (chunks <= k_maxBatchChunks) {
+        uint32_t cvs[k_maxBatchChunks * 8];
+        hashChunks(input, chunks, counter, cvs);
+
+        for (uint64_t number = chunks; number > 1; number /= 2) {
+            for (uint64_t i = 0; i < number / 2; ++i)
+                parentCv(cvs + i * 16, cvs + i * 16 + 8, cvs + i * 8);
+        }
+
+        std::memcpy(out, cvs, 32);
+        return;
+    }
+
+    const uint64_t half = chunks / 2;
+    const uint8_t *rightInput = input + half * k_chunkLen;
+    uint32_t left[8];
+    uint32_t right[8];
+
+    if (threads > 1 && half >= k_minParallelChunks) {
+        const int leftThreads = threads / 2;
+        std::thread leftThread([=, &left]{ subtreeCv(input, half, counter, leftThreads, left); });
+        subtreeCv(rightInput, half, counter + half, threads - leftThreads, right);
+        leftThread.join();
+    }
+    else {
+        subtreeCv(input, half, counter, 1, left);
+        subtreeCv(rightInput, half, counter + half, 1, right);
+    }
+
+    parentCv(left, right, out);
+}
+} // namespace
+
+Blake3::Blake3()
+{
+    reset();
+}
+
+void Blake3::reset()
+{
+    resetChunk(0);
+    m_cvStackLen = 0;
+}
+
+void Blake3::resetChunk(uint64_t counter)
+{
+    std::memcpy(m_chunk.cv, k_iv, 32);
+    std::memset(m_chunk.block, 0, k_blockLen);
+    m_chunk.counter = counter;
+    m_chunk.blockLen = 0;
+    m_chunk.blocksCompressed = 0;
+}
+
+void Blake3::updateChunk(const uint8_t *data, size_t length)
+{
+    while (length > 0) {
+        // the buffered block is compressed only when more input follows: the last one needs the ChunkEnd flag
+        if (m_chunk.blockLen == k_blockLen) {
+            const uint32_t flags = (m_chunk.blocksCompressed == 0) ? uint32_t(ChunkStart) : 0u;
+            uint32_t res[16];
+            compressBlock(m_chunk.cv, m_chunk.block, k_blockLen, m_chunk.counter, flags, res);
+            std::memcpy(m_chunk.cv, res, 32);
+            std::memset(m_chunk.block, 0, k_blockLen);
+            m_chunk.blockLen = 0;
+            ++m_chunk.blocksCompressed;
+        }
+
+        const size_t take = std::min(length, k_blockLen - m_chunk.blockLen);
+        std::memcpy(m_chunk.block + m_chunk.blockLen, data, take);
+        m_chunk.blockLen += static_cast<uint8_t>(take);
+        data += take;
+        length -= take;
+    }
+}
+
+void Blake3::pushCv(const uint32_t cv[8], uint64_t totalUnits)
+{
+    uint32_t merged[8];
+    std::memcpy(merged, cv, 32);
+
+    // a completed pair of subtrees of the same size is merged into the parent
+    while ((totalUnits & 1) == 0 && m_cvStackLen > 0) {
+        --m_cvStackLen;
+        parentCv(m_cvStack + m_cvStackLen * 8, merged, merged);
+        totalUnits >>= 1;
+    }
+
+    std::memcpy(m_cvStack + m_cvStackLen * 8, merged, 32);
+    ++m_cvStackLen;
+}
+
+void Blake3::addSubtree(const uint8_t *data, uint64_t chunks, int threads)
+{
+    uint32_t cv[8];
+    subtreeCv(data, chunks, m_chunk.counter, threads, cv);
+
+    const uint64_t nextCounter = m_chunk.counter + chunks;
+    pushCv(cv, nextCounter / chunks);
+    resetChunk(nextCounter);
+}
+
+void Blake3::update(const void *data, size_t length, int threads)
+{
+    const uint8_t *input = static_cast<const uint8_t*>(data);
+
+    while (length > 0) {
+        // the current chunk is complete and it's not the last one
+        if (m_chunk.length() == k_chunkLen) {
+            uint32_t res[16];
+            const uint32_t flags = ChunkEnd | ((m_chunk.blocksCompressed == 0) ? uint32_t(ChunkStart) : 0u);
+            compressBlock(m_chunk.cv, m_chunk.block, m_chunk.blockLen, m_chunk.counter, flags, res);
+
+            const uint64_t nextCounter = m_chunk.counter + 1;
+            pushCv(res, nextCounter);
+            resetChunk(nextCounter);
+        }
+
+        // the whole chunks are hashed directly from the input,
+        // at least one byte is left for the chunk state to be finalized as the root if needed
+        if (m_chunk.length() == 0 && length > k_chunkLen) {
+            uint64_t chunks = 1;
+            const uint64_t available = (length - 1) / k_chunkLen;
+
+            while (chunks * 2 <= available)
+                chunks *= 2;
+
+            // a subtree must start at a multiple of its size
+            while (m_chunk.counter & (chunks - 1))
+                chunks /= 2;
+
+            addSubtree(input, chunks, threads);
+            input += chunks * k_chunkLen;
+            length -= chunks * k_chunkLen;
+            continue;
+        }
+
+        const size_t take = std::min(length, k_chunkLen - m_chunk.length());
+        updateChunk(input, take);
+        input += take;
+        length -= take;
+    }
+}
+
+void Blake3::finalize(uint8_t *out) const
+{
+    uint32_t res[16];
+    uint32_t flags = ChunkEnd | ((m_chunk.blocksCompressed == 0) ? uint32_t(ChunkStart) : 0u);
+
+    if (m_cvStackLen == 0) {
+        compressBlock(m_chunk.cv, m_chunk.block, m_chunk.blockLen, 0, flags | Root, res);
+    }
+    else {
+        compressBlock(m_chunk.cv, m_chunk.block, m_chunk.blockLen, m_chunk.counter, flags, res);
+
+        uint32_t cv[8];
+        std::memcpy(cv, res, 32);
+
+        for (int i = m_cvStackLen - 1; i > 0; --i)
+            parentCv(m_cvStack + i * 8, cv, cv);
+
+        uint32_t m[16];
+        std::memcpy(m, m_cvStack, 32);
+        std::memcpy(m + 8, cv, 32);
+        compress(k_iv, m, 64, 0, Parent | Root, res);
+    }
+
+    for (size_t i = 0; i < k_outLen / 4; ++i)
+        storeLe(out + i * 4, res[i]);
+}
+
+// the chunk counter (8 bytes), CV, the number of compressed blocks and the buffered bytes,
+// then the CV stack; little-endian
+void Blake3::saveState(std::vector<uint8_t> &out) const
+{
+    out.clear();
+
+    for (size_t i = 0; i < 8; ++i)
+        out.push_back(static_cast<uint8_t>(m_chunk.counter >> (i * 8)));
+
+    uint8_t word[4];
+
+    for (size_t i = 0; i < 8; ++i) {
+        storeLe(word, m_chunk.cv[i]);
+        out.insert(out.end(), word, word + 4);
+    }
+
+    out.push_back(m_chunk.blocksCompressed);
+    out.push_back(m_chunk.blockLen);
+    out.insert(out.end(), m_chunk.block, m_chunk.block + m_chunk.blockLen);
+
+    out.push_back(m_cvStackLen);
+
+    for (size_t i = 0; i < size_t(m_cvStackLen) * 8; ++i) {
+        storeLe(word, m_cvStack[i]);
+        out.insert(out.end(), word, word + 4);
+    }
+}
+
+bool Blake3::loadState(const uint8_t *data, size_t length)
+{
+    // up to the buffered bytes
+    const size_t head = 8 + 32 + 2;
+
+    if (length < head + 1)
+        return false;
+
+    const uint8_t blocksCompressed = data[40];
+    const uint8_t blockLen = data[41];
+
+    if (blockLen > k_blockLen || blocksCompressed >= k_chunkLen / k_blockLen || length < head + blockLen + 1)
+        return false;
+
+    const uint8_t stackLen = data[head + blockLen];
+
+    if (stackLen > sizeof(m_cvStack) / 32 || length != head + blockLen + 1 + size_t(stackLen) * 32)
+        return false;
+
+    uint64_t counter = 0;
+
+    for (size_t i = 0; i < 8; ++i)
+        counter |= static_cast<uint64_t>(data[i]) << (i * 8);
+
+    resetChunk(counter);
+
+    for (size_t i = 0; i < 8; ++i)
+        m_chunk.cv[i] = loadLe(data + 8 + i * 4);
+
+    m_chunk.blocksCompressed = blocksCompressed;
+    m_chunk.blockLen = blockLen;
+    std::memcpy(m_chunk.block, data + head, blockLen);
+
+    const uint8_t *stack = data + head + blockLen + 1;
+    m_cvStackLen = stackLen;
+
+    for (size_t i = 0; i < size_t(stackLen) * 8; ++i)
+        m_cvStack[i] = loadLe(stack + i * 4);
+
+    return true;
+}
+
+const char* Blake3::simdName()
+{
+#ifdef VER_ARCH_X86
+    const CpuFeatures &cpu = CpuFeatures::current();
+
+    if (cpu.avx512)
+        return "AVX-512";
+    if (cpu.avx2)
+        return "AVX2";
+    if (cpu.sse41)
+        return "SSE4.1";
+#endif
+
+    return "Portable";
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef BLAKE3_H
+#define BLAKE3_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/* BLAKE3 hash function (regular hashing mode, 256-bit output).
+ * https://github.com/BLAKE3-team/BLAKE3-specs
+ *
+ * Full 1 KiB chunks are hashed several at a time by the SIMD kernels (SSE4.1, AVX2, AVX-512),
+ * selected at runtime by the CPU features. Large inputs can additionally be split into
+ * subtrees hashed by several threads (::update with threads > 1); the result is the same.
+ */
+class Blake3
+{
+public:
+    Blake3();
+
+    void reset();
+
+    // 'threads' > 1 allows splitting large inputs into subtrees hashed in parallel
+    void update(const void *data, size_t length, int threads = 1);
+
+    // writes the 32-byte digest, the state is not changed
+    void finalize(uint8_t *out) const;
+
+    // the intermediate state to continue the hashing from later (e.g. a grown file); the same on all CPUs
+    void saveState(std::vector<uint8_t> &out) const;
+
+    // returns false if the 'data' is not a saved state, the current one is kept then
+    bool loadState(const uint8_t *data, size_t length);
+
+    // "AVX-512", "AVX2", "SSE4.1" or "Portable"
+    static const char* simdName();
+
+    static constexpr size_t k_outLen = 32;
+    static constexpr size_t k_blockLen = 64;
+    static constexpr size_t k_chunkLen = 1024;
+
+private:
+    struct ChunkState {
+        uint32_t cv[8];
+        uint64_t counter = 0;
+        uint8_t block[k_blockLen];
+        uint8_t blockLen = 0;
+        uint8_t blocksCompressed = 0;
+
+        size_t length() const { return k_blockLen * blocksCompressed + blockLen; }
+    };
+
+    void resetChunk(uint64_t counter);
+    void updateChunk(const uint8_t *data, size_t length);
+
+    // hashes 'chunks' (power of 2) full chunks as a complete subtree and adds its CV to the stack
+    void addSubtree(const uint8_t *data, uint64_t chunks, int threads);
+    void pushCv(const uint32_t cv[8], uint64_t totalUnits);
+
+    ChunkState m_chunk;
+    uint32_t m_cvStack[54 * 8];
+    uint8_t m_cvStackLen = 0;
+}; // class Blake3
+
+#endif // BLAKE3_H
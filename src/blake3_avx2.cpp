@@ -0,0 +1,89 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "blake3_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+
+namespace blake3 {
+namespace {
+struct V256 {
+    using T = __m256i;
+    static constexpr size_t lanes = 8;
+
+    static T set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static T add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm256_xor_si256(a, b); }
+
+    static T rot16(T x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                                      13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+    }
+
+    static T rot12(T x) { return _mm256_or_si256(_mm256_srli_epi32(x, 12), _mm256_slli_epi32(x, 20)); }
+
+    static T rot8(T x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+                                                      12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+    }
+
+    static T rot7(T x) { return _mm256_or_si256(_mm256_srli_epi32(x, 7), _mm256_slli_epi32(x, 25)); }
+    static T load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t *p, T x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+
+    static __m128i loadu(const uint8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+    static void transpose(__m128i &a, __m128i &b, __m128i &c, __m128i &d)
+    {
+        const __m128i ab_lo = _mm_unpacklo_epi32(a, b);
+        const __m128i ab_hi = _mm_unpackhi_epi32(a, b);
+        const __m128i cd_lo = _mm_unpacklo_epi32(c, d);
+        const __m128i cd_hi = _mm_unpackhi_epi32(c, d);
+
+        a = _mm_unpacklo_epi64(ab_lo, cd_lo);
+        b = _mm_unpackhi_epi64(ab_lo, cd_lo);
+        c = _mm_unpacklo_epi64(ab_hi, cd_hi);
+        d = _mm_unpackhi_epi64(ab_hi, cd_hi);
+    }
+
+    static T combine(__m128i lo, __m128i hi)
+    {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    }
+
+    // lanes 0-3 and 4-7 are transposed separately and combined into the lower and upper halves
+    static void loadMsg(const uint8_t *input, size_t block, T m[16])
+    {
+        const uint8_t *p = input + block * 64;
+
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i lo[4];
+            __m128i hi[4];
+
+            for (size_t lane = 0; lane < 4; ++lane) {
+                lo[lane] = loadu(p + lane * k_chunkLen + i * 16);
+                hi[lane] = loadu(p + (lane + 4) * k_chunkLen + i * 16);
+            }
+
+            transpose(lo[0], lo[1], lo[2], lo[3]);
+            transpose(hi[0], hi[1], hi[2], hi[3]);
+
+            for (size_t w = 0; w < 4; ++w)
+                m[i * 4 + w] = combine(lo[w], hi[w]);
+        }
+    }
+}; // struct V256
+} // namespace
+
+void hashChunksAvx2(const uint8_t *input, uint64_t counter, uint32_t *out)
+{
+    hashChunks<V256>(input, counter, out);
+}
+} // namespace blake3
+
+#endif // VER_ARCH_X86
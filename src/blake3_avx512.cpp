@@ -0,0 +1,53 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "blake3_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+
+namespace blake3 {
+namespace {
+struct V512 {
+    using T = __m512i;
+    static constexpr size_t lanes = 16;
+
+    static T set1(uint32_t x) { return _mm512_set1_epi32(static_cast<int>(x)); }
+    static T add(T a, T b) { return _mm512_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm512_xor_si512(a, b); }
+    static T rot16(T x) { return _mm512_ror_epi32(x, 16); }
+    static T rot12(T x) { return _mm512_ror_epi32(x, 12); }
+    static T rot8(T x) { return _mm512_ror_epi32(x, 8); }
+    static T rot7(T x) { return _mm512_ror_epi32(x, 7); }
+    static T load(const uint32_t *p) { return _mm512_loadu_si512(p); }
+    static void store(uint32_t *p, T x) { _mm512_storeu_si512(p, x); }
+
+    // the word offsets of the lanes (chunks) in the input
+    static T chunkOffsets()
+    {
+        const int w = static_cast<int>(k_chunkLen / 4);
+        return _mm512_setr_epi32(0, w, 2 * w, 3 * w, 4 * w, 5 * w, 6 * w, 7 * w,
+                                 8 * w, 9 * w, 10 * w, 11 * w, 12 * w, 13 * w, 14 * w, 15 * w);
+    }
+
+    static void loadMsg(const uint8_t *input, size_t block, T m[16])
+    {
+        const T offsets = chunkOffsets();
+
+        for (size_t i = 0; i < 16; ++i) {
+            const T ind = _mm512_add_epi32(offsets, set1(static_cast<uint32_t>(block * 16 + i)));
+            m[i] = _mm512_i32gather_epi32(ind, input, 4);
+        }
+    }
+}; // struct V512
+} // namespace
+
+void hashChunksAvx512(const uint8_t *input, uint64_t counter, uint32_t *out)
+{
+    hashChunks<V512>(input, counter, out);
+}
+} // namespace blake3
+
+#endif // VER_ARCH_X86
@@ -0,0 +1,150 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef BLAKE3_P_H
+#define BLAKE3_P_H
+
+/* BLAKE3 internals shared by the portable code (blake3.cpp)
+ * and the SIMD kernels (blake3_sse41/avx2/avx512.cpp).
+ * Each kernel file is compiled with its own instruction set flags.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include "cpufeatures.h"
+
+namespace blake3 {
+
+enum Flags : uint32_t {
+    ChunkStart = 1 << 0,
+    ChunkEnd = 1 << 1,
+    Parent = 1 << 2,
+    Root = 1 << 3
+};
+
+static constexpr uint32_t k_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+// the message words permutation, precomputed for each of the 7 rounds
+static constexpr uint8_t k_msgSchedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}
+};
+
+static constexpr size_t k_blocksPerChunk = 16;
+static constexpr size_t k_chunkLen = 1024;
+
+#ifdef VER_ARCH_X86
+/* Each kernel hashes exactly 'lanes' full contiguous chunks of the 'input',
+ * with the chunk counters counter...counter + lanes - 1.
+ * The chaining values are written to the 'out': 8 words per chunk.
+ */
+void hashChunksSse41(const uint8_t *input, uint64_t counter, uint32_t *out); // 4 lanes
+void hashChunksAvx2(const uint8_t *input, uint64_t counter, uint32_t *out);  // 8 lanes
+void hashChunksAvx512(const uint8_t *input, uint64_t counter, uint32_t *out); // 16 lanes
+#endif
+
+namespace {
+/* The vectorized chunk hashing. 'V' provides the operations on a vector of 'V::lanes' words:
+ * set1, add, xor_, rot16/12/8/7 (rotate right), load, store
+ * and loadMsg (the message words of the block for each lane).
+ */
+template <typename V>
+inline void g(typename V::T v[16], size_t a, size_t b, size_t c, size_t d,
+              typename V::T mx, typename V::T my)
+{
+    v[a] = V::add(V::add(v[a], v[b]), mx);
+    v[d] = V::rot16(V::xor_(v[d], v[a]));
+    v[c] = V::add(v[c], v[d]);
+    v[b] = V::rot12(V::xor_(v[b], v[c]));
+    v[a] = V::add(V::add(v[a], v[b]), my);
+    v[d] = V::rot8(V::xor_(v[d], v[a]));
+    v[c] = V::add(v[c], v[d]);
+    v[b] = V::rot7(V::xor_(v[b], v[c]));
+}
+
+template <typename V>
+inline void mixRound(typename V::T v[16], const typename V::T m[16], size_t r)
+{
+    const uint8_t *s = k_msgSchedule[r];
+
+    // columns
+    g<V>(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+    g<V>(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+    g<V>(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+    g<V>(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+
+    // diagonals
+    g<V>(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+    g<V>(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    g<V>(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+    g<V>(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+}
+
+template <typename V>
+inline void hashChunks(const uint8_t *input, uint64_t counter, uint32_t *out)
+{
+    using T = typename V::T;
+
+    alignas(64) uint32_t lo[V::lanes];
+    alignas(64) uint32_t hi[V::lanes];
+
+    for (size_t i = 0; i < V::lanes; ++i) {
+        lo[i] = static_cast<uint32_t>(counter + i);
+        hi[i] = static_cast<uint32_t>((counter + i) >> 32);
+    }
+
+    const T counterLow = V::load(lo);
+    const T counterHigh = V::load(hi);
+
+    T h[8];
+    for (size_t i = 0; i < 8; ++i)
+        h[i] = V::set1(k_iv[i]);
+
+    for (size_t block = 0; block < k_blocksPerChunk; ++block) {
+        T m[16];
+        V::loadMsg(input, block, m);
+
+        uint32_t flags = 0;
+        if (block == 0)
+            flags |= ChunkStart;
+        if (block == k_blocksPerChunk - 1)
+            flags |= ChunkEnd;
+
+        T v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            V::set1(k_iv[0]), V::set1(k_iv[1]), V::set1(k_iv[2]), V::set1(k_iv[3]),
+            counterLow, counterHigh, V::set1(64), V::set1(flags)
+        };
+
+        for (size_t r = 0; r < 7; ++r)
+            mixRound<V>(v, m, r);
+
+        for (size_t i = 0; i < 8; ++i)
+            h[i] = V::xor_(v[i], v[i + 8]);
+    }
+
+    // transposing back: 8 words per lane
+    alignas(64) uint32_t words[V::lanes];
+
+    for (size_t i = 0; i < 8; ++i) {
+        V::store(words, h[i]);
+
+        for (size_t lane = 0; lane < V::lanes; ++lane)
+            out[lane * 8 + i] = words[lane];
+    }
+}
+} // namespace
+
+} // namespace blake3
+
+#endif // BLAKE3_P_H
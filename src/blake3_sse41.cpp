@@ -0,0 +1,70 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "blake3_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+
+namespace blake3 {
+namespace {
+struct V128 {
+    using T = __m128i;
+    static constexpr size_t lanes = 4;
+
+    static T set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static T add(T a, T b) { return _mm_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm_xor_si128(a, b); }
+    static T rot16(T x) { return _mm_shuffle_epi8(x, _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2)); }
+    static T rot12(T x) { return _mm_or_si128(_mm_srli_epi32(x, 12), _mm_slli_epi32(x, 20)); }
+    static T rot8(T x) { return _mm_shuffle_epi8(x, _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1)); }
+    static T rot7(T x) { return _mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25)); }
+    static T load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t *p, T x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+
+    static T loadu(const uint8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+    // 4 words of 4 lanes --> 4 vectors of the same word of each lane
+    static void transpose(T &a, T &b, T &c, T &d)
+    {
+        const T ab_lo = _mm_unpacklo_epi32(a, b);
+        const T ab_hi = _mm_unpackhi_epi32(a, b);
+        const T cd_lo = _mm_unpacklo_epi32(c, d);
+        const T cd_hi = _mm_unpackhi_epi32(c, d);
+
+        a = _mm_unpacklo_epi64(ab_lo, cd_lo);
+        b = _mm_unpackhi_epi64(ab_lo, cd_lo);
+        c = _mm_unpacklo_epi64(ab_hi, cd_hi);
+        d = _mm_unpackhi_epi64(ab_hi, cd_hi);
+    }
+
+    static void loadMsg(const uint8_t *input, size_t block, T m[16])
+    {
+        const uint8_t *p = input + block * 64;
+
+        for (size_t i = 0; i < 4; ++i) {
+            T a = loadu(p + i * 16);
+            T b = loadu(p + k_chunkLen + i * 16);
+            T c = loadu(p + 2 * k_chunkLen + i * 16);
+            T d = loadu(p + 3 * k_chunkLen + i * 16);
+
+            transpose(a, b, c, d);
+
+            m[i * 4] = a;
+            m[i * 4 + 1] = b;
+            m[i * 4 + 2] = c;
+            m[i * 4 + 3] = d;
+        }
+    }
+}; // struct V128
+} // namespace
+
+void hashChunksSse41(const uint8_t *input, uint64_t counter, uint32_t *out)
+{
+    hashChunks<V128>(input, counter, out);
+}
+} // namespace blake3
+
+#endif // VER_ARCH_X86
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "blocklist.h"
+#include <QStringList>
+
+BlockList::BlockList(qint64 fileSize, qint64 blockSize, const QByteArray &digests, int digestLength)
+    : m_fileSize(fileSize), m_blockSize(blockSize), m_digests(digests), m_digestLength(digestLength)
+{}
+
+BlockList BlockList::fromString(const QString &str, int digestLength)
+{
+    qint64 fileSize = 0;
+    qint64 blockSize = 0;
+
+    if (digestLength < 1 || !parseSizes(str, fileSize, blockSize))
+        return BlockList();
+
+    const int sep = str.indexOf(':', str.indexOf(':') + 1);
+    const QByteArray digests = QByteArray::fromHex(str.mid(sep + 1).toLatin1());
+
+    const BlockList res(fileSize, blockSize, digests, digestLength);
+    return res.isValid() ? res : BlockList();
+}
+
+QString BlockList::toString() const
+{
+    if (!isValid())
+        return QString();
+
+    return QString::number(m_fileSize) + ':' + QString::number(m_blockSize) + ':'
+           + QString::fromLatin1(m_digests.toHex());
+}
+
+bool BlockList::parseSizes(const QString &str, qint64 &fileSize, qint64 &blockSize)
+{
+    const int sep1 = str.indexOf(':');
+    const int sep2 = (sep1 > 0) ? str.indexOf(':', sep1 + 1) : -1;
+
+    if (sep2 < 0)
+        return false;
+
+    bool ok1 = false;
+    bool ok2 = false;
+    fileSize = str.left(sep1).toLongLong(&ok1);
+    blockSize = str.mid(sep1 + 1, sep2 - sep1 - 1).toLongLong(&ok2);
+
+    return ok1 && ok2 && fileSize > 0 && blockSize > 0;
+}
+
+bool BlockList::isValid() const
+{
+    return m_blockSize > 0
+           && m_digestLength > 0
+           && m_digests.size() == blockCount(m_fileSize, m_blockSize) * m_digestLength;
+}
+
+qint64 BlockList::fileSize() const
+{
+    return m_fileSize;
+}
+
+qint64 BlockList::blockSize() const
+{
+    return m_blockSize;
+}
+
+int BlockList::count() const
+{
+    return (m_digestLength > 0) ? (m_digests.size() / m_digestLength) : 0;
+}
+
+QByteArray BlockList::digest(int block) const
+{
+    if (block < 0 || block >= count())
+        return QByteArray();
+
+    return m_digests.mid(block * m_digestLength, m_digestLength);
+}
+
+int BlockList::blockCount(qint64 fileSize, qint64 blockSize)
+{
+    if (fileSize <= 0 || blockSize <= 0)
+        return 0;
+
+    return int((fileSize + blockSize - 1) / blockSize);
+}
+
+qint64 BlockList::blockLength(int block) const
+{
+    const qint64 offset = block * m_blockSize;
+
+    return (offset < m_fileSize) ? qMin(m_blockSize, m_fileSize - offset) : 0;
+}
+
+QList<QPair<qint64, qint64>> BlockList::ranges(const QList<int> &blocks, qint64 fileSize, qint64 blockSize)
+{
+    QList<QPair<qint64, qint64>> res;
+
+    for (const int block : blocks) {
+        const qint64 offset = block * blockSize;
+
+        if (offset >= fileSize)
+            break;
+
+        const qint64 length = qMin(blockSize, fileSize - offset);
+
+        if (!res.isEmpty() && res.last().first + res.last().second == offset)
+            res.last().second += length;
+        else
+            res.append({ offset, length });
+    }
+
+    return res;
+}
+
+QString BlockList::rangesToString(const QList<QPair<qint64, qint64>> &ranges)
+{
+    QStringList res;
+
+    for (const QPair<qint64, qint64> &range : ranges)
+        res << QString::number(range.first) + '-' + QString::number(range.first + range.second - 1);
+
+    return res.join(QStringLiteral(u", "));
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef BLOCKLIST_H
+#define BLOCKLIST_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QPair>
+
+/* The digests of the consecutive blocks of a large file (of the main algorithm),
+ * stored along with the full checksum to find out which parts of a mismatched file have changed,
+ * and to verify a single file by several threads (each its own blocks).
+ * The string form (db file): "<file size>:<block size>:<hex digests of all blocks, joined>".
+ */
+class BlockList
+{
+public:
+    BlockList() = default;
+    BlockList(qint64 fileSize, qint64 blockSize, const QByteArray &digests, int digestLength);
+
+    // 'digestLength' in bytes; an invalid list if the string does not match it
+    static BlockList fromString(const QString &str, int digestLength);
+    QString toString() const;
+
+    // the sizes only, without decoding the digests; returns false if there are none
+    static bool parseSizes(const QString &str, qint64 &fileSize, qint64 &blockSize);
+
+    // the number of digests matches the file size
+    bool isValid() const;
+    qint64 fileSize() const;
+    qint64 blockSize() const;
+    int count() const;
+
+    // the raw digest of the block
+    QByteArray digest(int block) const;
+
+    // the number of blocks of the file
+    static int blockCount(qint64 fileSize, qint64 blockSize);
+
+    // the length of the block (the last one may be shorter)
+    qint64 blockLength(int block) const;
+
+    // the {offset, length} ranges of the 'blocks' (ascending), the adjacent ones merged
+    static QList<QPair<qint64, qint64>> ranges(const QList<int> &blocks, qint64 fileSize, qint64 blockSize);
+
+    // "0-4194303, 12582912-16777215" (bytes, inclusive)
+    static QString rangesToString(const QList<QPair<qint64, qint64>> &ranges);
+
+private:
+    qint64 m_fileSize = 0;
+    qint64 m_blockSize = 0;
+    QByteArray m_digests; // raw, joined
+    int m_digestLength = 0;
+}; // class BlockList
+
+#endif // BLOCKLIST_H
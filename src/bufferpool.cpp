@@ -0,0 +1,126 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "bufferpool.h"
+#include <new>
+
+/*** BufferPool::Buffer ***/
+BufferPool::Buffer::Buffer(Buffer &&other) noexcept
+    : m_pool(other.m_pool), m_data(other.m_data), m_size(other.m_size)
+{
+    other.m_data = nullptr;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+    }
+
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer()
+{
+    release();
+}
+
+void BufferPool::Buffer::release()
+{
+    if (m_data && m_pool)
+        m_pool->release(m_data, m_size);
+
+    m_data = nullptr;
+}
+
+/*** BufferPool ***/
+BufferPool::~BufferPool()
+{
+    clear();
+}
+
+char* BufferPool::allocate(qint64 size)
+{
+    return static_cast<char*>(::operator new(static_cast<size_t>(size), std::align_val_t(s_alignment)));
+}
+
+void BufferPool::deallocate(char *data)
+{
+    ::operator delete(data, std::align_val_t(s_alignment));
+}
+
+void BufferPool::reserve(qint64 size, int number)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_capacity[size] = number;
+
+    QList<char*> &idle = m_idle[size];
+
+    while (idle.size() < number)
+        idle.append(allocate(size));
+
+    while (idle.size() > number)
+        deallocate(idle.takeLast());
+}
+
+void BufferPool::setCapacity(qint64 size, int number)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity[size] = number;
+}
+
+BufferPool::Buffer BufferPool::acquire(qint64 size)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        QList<char*> &idle = m_idle[size];
+
+        if (!idle.isEmpty()) {
+            ++m_hits;
+            return Buffer(this, idle.takeLast(), size);
+        }
+    }
+
+    ++m_misses;
+    return Buffer(this, allocate(size), size);
+}
+
+void BufferPool::release(char *data, qint64 size)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<char*> &idle = m_idle[size];
+
+    if (idle.size() < m_capacity.value(size, s_defaultCapacity))
+        idle.append(data);
+    else
+        deallocate(data);
+}
+
+void BufferPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (QList<char*> &idle : m_idle) {
+        for (char *data : std::as_const(idle))
+            deallocate(data);
+    }
+
+    m_idle.clear();
+}
+
+quint64 BufferPool::hits() const
+{
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+quint64 BufferPool::misses() const
+{
+    return m_misses.load(std::memory_order_relaxed);
+}
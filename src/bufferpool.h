@@ -0,0 +1,85 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <atomic>
+
+/* A thread-safe pool of page-aligned file read buffers,
+ * shared by the hashers to avoid allocating (and page faulting) a new buffer for every read chunk.
+ * The buffers are grouped by size; the released ones are kept for reuse up to the capacity
+ * set for their size (::reserve), the rest are freed.
+ */
+class BufferPool
+{
+public:
+    // a buffer taken from the pool, returned back on destruction
+    class Buffer
+    {
+    public:
+        Buffer() = default;
+        Buffer(Buffer &&other) noexcept;
+        Buffer& operator=(Buffer &&other) noexcept;
+        ~Buffer();
+
+        char* data() const { return m_data; }
+        qint64 size() const { return m_size; }
+        explicit operator bool() const { return m_data != nullptr; }
+
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool *pool, char *data, qint64 size)
+            : m_pool(pool), m_data(data), m_size(size) {}
+
+        void release();
+
+        BufferPool *m_pool = nullptr;
+        char *m_data = nullptr;
+        qint64 m_size = 0;
+    }; // class Buffer
+
+    BufferPool() = default;
+    ~BufferPool();
+
+    static const qint64 s_alignment = 4096;
+
+    // keeps up to 'number' idle buffers of the 'size', preallocating the missing ones
+    void reserve(qint64 size, int number);
+
+    // keeps up to 'number' idle buffers of the 'size', allocated as they are needed
+    void setCapacity(qint64 size, int number);
+
+    // a pooled buffer if available (hit), otherwise a newly allocated one (miss)
+    Buffer acquire(qint64 size);
+
+    // frees all idle buffers
+    void clear();
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    Q_DISABLE_COPY(BufferPool)
+
+    static char* allocate(qint64 size);
+    static void deallocate(char *data);
+    void release(char *data, qint64 size);
+
+    // buffers of the size not reserved are still reused, a few at most
+    static const int s_defaultCapacity = 2;
+
+    QMutex m_mutex;
+    QHash<qint64, QList<char*>> m_idle;   // {size : idle buffers}
+    QHash<qint64, int> m_capacity;        // {size : max number of idle buffers}
+
+    std::atomic<quint64> m_hits { 0 };
+    std::atomic<quint64> m_misses { 0 };
+}; // class BufferPool
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,264 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "checkpoint.h"
+#include "algostring.h"
+#include <QFileInfo>
+#include <QDebug>
+
+#if defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+static const QByteArray s_signature = QByteArrayLiteral("veretino-checkpoint\t1");
+
+// the keys of the item values; any other key is the name of an extra algorithm
+static const QByteArray s_keyFingerprint = QByteArrayLiteral("fingerprint");
+static const QByteArray s_keySample = QByteArrayLiteral("sample");
+static const QByteArray s_keyBlocks = QByteArrayLiteral("blocks");
+static const QByteArray s_keyTail = QByteArrayLiteral("tail");
+static const QByteArray s_keyChanged = QByteArrayLiteral("changed");
+
+Checkpoint::~Checkpoint()
+{
+    if (isOpen())
+        close(false);
+}
+
+QString Checkpoint::filePath(const QString &dbFilePath)
+{
+    return dbFilePath + QStringLiteral(u".checkpoint");
+}
+
+bool Checkpoint::exists(const QString &dbFilePath)
+{
+    return QFileInfo::exists(filePath(dbFilePath));
+}
+
+bool Checkpoint::remove(const QString &dbFilePath)
+{
+    return QFile::remove(filePath(dbFilePath));
+}
+
+bool Checkpoint::readInfo(const QString &dbFilePath, Kind &kind, QCryptographicHash::Algorithm &algo)
+{
+    QFile file(filePath(dbFilePath));
+    return file.open(QFile::ReadOnly) && readHeader(file.readLine(), kind, algo);
+}
+
+QByteArray Checkpoint::header(Kind kind, QCryptographicHash::Algorithm algo)
+{
+    return s_signature + '\t' + (kind == Creation ? "creation" : "verification")
+           + '\t' + AlgoString::name(algo).toUtf8() + '\n';
+}
+
+bool Checkpoint::readHeader(const QByteArray &line, Kind &kind, QCryptographicHash::Algorithm &algo)
+{
+    if (!line.startsWith(s_signature))
+        return false;
+
+    const QList<QByteArray> fields = line.trimmed().split('\t');
+
+    if (fields.size() < 4)
+        return false;
+
+    kind = (fields.at(2) == "creation") ? Creation : Verification;
+    algo = AlgoString::strToAlgo(QString::fromUtf8(fields.at(3)));
+    return true;
+}
+
+bool Checkpoint::open(const QString &dbFilePath, Kind kind, QCryptographicHash::Algorithm algo, bool resume)
+{
+    if (isOpen())
+        close(false);
+
+    m_file.setFileName(filePath(dbFilePath));
+    m_kind = kind;
+    m_algo = algo;
+    m_buffer.clear();
+
+    // the existing records are continued only if they are of the same process
+    bool isContinued = false;
+    bool isLineCut = false;
+
+    if (resume && m_file.open(QFile::ReadOnly)) {
+        Kind prevKind;
+        QCryptographicHash::Algorithm prevAlgo;
+        isContinued = readHeader(m_file.readLine(), prevKind, prevAlgo) && prevKind == kind && prevAlgo == algo;
+
+        // the last record written partially: it is left on its own line
+        isLineCut = isContinued && m_file.seek(m_file.size() - 1) && m_file.read(1) != "\n";
+        m_file.close();
+    }
+
+    if (!m_file.open(isContinued ? (QFile::WriteOnly | QFile::Append) : (QFile::WriteOnly | QFile::Truncate))) {
+        qWarning() << "Checkpoint: can't open" << m_file.fileName();
+        return false;
+    }
+
+    if (!isContinued)
+        m_buffer = header(kind, algo);
+    else if (isLineCut)
+        m_buffer = "\n";
+
+    m_lastFlush.start();
+    return flush();
+}
+
+bool Checkpoint::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void Checkpoint::add(const QString &relPath, const Item &item)
+{
+    if (!isOpen())
+        return;
+
+    // the values are hex, base64 or numbers: no ';' or tabs in them
+    QList<QByteArray> values;
+    for (auto it = item.extraChecksums.constBegin(); it != item.extraChecksums.constEnd(); ++it)
+        values << AlgoString::name(it.key()).toLatin1() + '=' + it.value().toLatin1();
+
+    if (!item.fingerprint.isEmpty())
+        values << s_keyFingerprint + '=' + item.fingerprint.toLatin1();
+    if (!item.sampleChecksum.isEmpty())
+        values << s_keySample + '=' + item.sampleChecksum.toLatin1();
+    if (!item.blockChecksums.isEmpty())
+        values << s_keyBlocks + '=' + item.blockChecksums.toLatin1();
+    if (!item.tailState.isEmpty())
+        values << s_keyTail + '=' + item.tailState.toLatin1();
+
+    if (!item.changedBlocks.isEmpty()) {
+        QList<QByteArray> blocks;
+        for (const int block : item.changedBlocks)
+            blocks << QByteArray::number(block);
+        values << s_keyChanged + '=' + blocks.join(',');
+    }
+
+    m_buffer += QByteArray::number(static_cast<int>(item.status)) + '\t'
+                + item.checksum.toLatin1() + '\t'
+                + values.join(';') + '\t'
+                + relPath.toUtf8() + '\n';
+}
+
+bool Checkpoint::isDue() const
+{
+    return isOpen() && !m_buffer.isEmpty() && m_lastFlush.hasExpired(s_intervalMs);
+}
+
+bool Checkpoint::flush()
+{
+    if (!isOpen())
+        return false;
+
+    m_lastFlush.restart();
+
+    if (m_buffer.isEmpty())
+        return true;
+
+    const bool isWritten = (m_file.write(m_buffer) == m_buffer.size()) && m_file.flush();
+    m_buffer.clear();
+
+#if defined(Q_OS_UNIX)
+    // surviving a power loss, not only a crash of the app
+    if (isWritten)
+        ::fsync(m_file.handle());
+#endif
+
+    if (!isWritten)
+        qWarning() << "Checkpoint: write error" << m_file.fileName();
+
+    return isWritten;
+}
+
+void Checkpoint::close(bool completed)
+{
+    if (!isOpen())
+        return;
+
+    if (completed) {
+        m_buffer.clear();
+        m_file.remove();
+    } else {
+        flush();
+        m_file.close();
+    }
+}
+
+bool Checkpoint::load(const QString &dbFilePath)
+{
+    m_items.clear();
+
+    QFile file(filePath(dbFilePath));
+
+    if (!file.open(QFile::ReadOnly) || !readHeader(file.readLine(), m_kind, m_algo))
+        return false;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+
+        // the last line may be incomplete (crash while writing)
+        if (!line.endsWith('\n'))
+            break;
+
+        const QList<QByteArray> fields = line.chopped(1).split('\t');
+
+        if (fields.size() < 4)
+            continue;
+
+        Item item;
+        item.status = static_cast<FileValues::FileStatus>(fields.at(0).toInt());
+        item.checksum = QString::fromLatin1(fields.at(1));
+
+        for (const QByteArray &pair : fields.at(2).split(';')) {
+            // the base64 of a tail state may end with '='
+            const int sep = pair.indexOf('=');
+            if (sep <= 0)
+                continue;
+
+            const QByteArray key = pair.left(sep);
+            const QString value = QString::fromLatin1(pair.mid(sep + 1));
+
+            if (key == s_keyFingerprint) {
+                item.fingerprint = value;
+            } else if (key == s_keySample) {
+                item.sampleChecksum = value;
+            } else if (key == s_keyBlocks) {
+                item.blockChecksums = value;
+            } else if (key == s_keyTail) {
+                item.tailState = value;
+            } else if (key == s_keyChanged) {
+                for (const QString &block : value.split(',', Qt::SkipEmptyParts))
+                    item.changedBlocks << block.toInt();
+            } else {
+                const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(QString::fromLatin1(key));
+                if (algo)
+                    item.extraChecksums[algo] = value;
+            }
+        }
+
+        // the path may contain tabs
+        const QString path = QString::fromUtf8(fields.mid(3).join('\t'));
+        m_items[path] = item;
+    }
+
+    return true;
+}
+
+Checkpoint::Kind Checkpoint::kind() const
+{
+    return m_kind;
+}
+
+QCryptographicHash::Algorithm Checkpoint::algorithm() const
+{
+    return m_algo;
+}
+
+const QHash<QString, Checkpoint::Item>& Checkpoint::items() const
+{
+    return m_items;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include "filevalues.h"
+
+/* The progress of a long process (db creation or verification), saved to a sidecar file
+ * next to the db file (*.ver.json.checkpoint), so it can be resumed after a crash or power loss.
+ * The results of the processed items are kept in memory and appended to the file periodically
+ * (::isDue, ::flush), each time synced to the disk. A line per item:
+ * status <tab> checksum <tab> values (KEY=value;...) <tab> relative path
+ * The values are the extra checksums (keyed by the algorithm name) and the other digests and states
+ * of the item that are stored in the db (fingerprint, sample, blocks, tail, changed).
+ * The file is removed when the process is completed and its results are in the db (or not needed).
+ */
+class Checkpoint
+{
+public:
+    enum Kind : quint8 { Creation, Verification };
+
+    struct Item {
+        FileValues::FileStatus status = FileValues::NotSet;
+        QString checksum;   // Creation: the calculated one; Verification: the recomputed one if mismatched
+        QMap<QCryptographicHash::Algorithm, QString> extraChecksums;
+        QString fingerprint;        // the file state the checksum is valid for (storage::fingerprint)
+        QString sampleChecksum;     // Creation
+        QString blockChecksums;     // Creation: BlockList::toString
+        QString tailState;          // TailState::toString
+        QList<int> changedBlocks;   // Verification: the mismatched blocks of the file
+    }; // struct Item
+
+    ~Checkpoint();
+
+    // "<dbFilePath>.checkpoint"
+    static QString filePath(const QString &dbFilePath);
+    static bool exists(const QString &dbFilePath);
+    static bool remove(const QString &dbFilePath);
+
+    // reads the header only; returns false if there is no valid file
+    static bool readInfo(const QString &dbFilePath, Kind &kind, QCryptographicHash::Algorithm &algo);
+
+    // starts writing; 'resume': the records are appended to the existing file of the same kind and algo
+    bool open(const QString &dbFilePath, Kind kind, QCryptographicHash::Algorithm algo, bool resume);
+    bool isOpen() const;
+
+    void add(const QString &relPath, const Item &item);
+
+    // it's time to write the buffered records
+    bool isDue() const;
+
+    // writes the buffered records and syncs the file
+    bool flush();
+
+    // the process is completed: the file is removed; otherwise (stopped) it's flushed and kept
+    void close(bool completed);
+
+    // reads the file; returns false if there is no valid one
+    bool load(const QString &dbFilePath);
+    Kind kind() const;
+    QCryptographicHash::Algorithm algorithm() const;
+    const QHash<QString, Item>& items() const;
+
+private:
+    static bool readHeader(const QByteArray &line, Kind &kind, QCryptographicHash::Algorithm &algo);
+    static QByteArray header(Kind kind, QCryptographicHash::Algorithm algo);
+
+    // the interval of syncing the results to the disk
+    static const int s_intervalMs = 30000;
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_lastFlush;
+
+    Kind m_kind = Creation;
+    QCryptographicHash::Algorithm m_algo = QCryptographicHash::Sha256;
+    QHash<QString, Item> m_items; // the loaded ones
+}; // class Checkpoint
+
+#endif // CHECKPOINT_H
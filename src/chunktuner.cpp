@@ -0,0 +1,129 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "chunktuner.h"
+#include "bufferpool.h"
+#include "storage.h"
+#include "tools.h"
+#include <QStringList>
+
+ChunkTuner::ChunkTuner(int initialChunk)
+    : m_initialChunk(qBound(s_minChunk, initialChunk, s_maxChunk))
+{}
+
+int ChunkTuner::chunkSize(quint64 device)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_devices.contains(device)) {
+        Device &dev = m_devices[device];
+        dev.current = m_initialChunk;
+        dev.probe = m_initialChunk;
+    }
+
+    return m_devices[device].probe;
+}
+
+void ChunkTuner::addSample(quint64 device, int chunk, qint64 bytes, qint64 nsecs)
+{
+    if (bytes <= 0 || nsecs <= 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_devices.contains(device))
+        return;
+
+    Device &dev = m_devices[device];
+
+    // the reads of the previous probe, still in progress by other hashers
+    if (chunk != dev.probe)
+        return;
+
+    Measure &measure = dev.measures[chunk];
+    measure.bytes += bytes;
+    measure.nsecs += nsecs;
+    measure.reads += (bytes + chunk - 1) / chunk;
+
+    // the settled size is still measured for the summary
+    if (!dev.settled && measure.bytes >= s_sampleBytes)
+        step(dev);
+}
+
+void ChunkTuner::step(Device &dev)
+{
+    if (dev.probe != dev.current) {
+        const double probeRate = dev.measures.value(dev.probe).rate();
+        const double currentRate = dev.measures.value(dev.current).rate();
+
+        // a larger size should be notably faster; a smaller one (less memory and latency) should just not be slower
+        const bool isBetter = (dev.probe > dev.current) ? (probeRate > currentRate * s_minGain)
+                                                        : (probeRate >= currentRate);
+
+        if (isBetter)
+            dev.current = dev.probe;
+        else if (dev.direction > 0)
+            dev.direction = -1;
+        else
+            dev.settled = true;
+    }
+
+    while (!dev.settled) {
+        const int next = (dev.direction > 0) ? dev.current * 2 : dev.current / 2;
+
+        if (next >= s_minChunk && next <= s_maxChunk && !dev.measures.contains(next)) {
+            dev.probe = next;
+            return;
+        }
+
+        if (dev.direction > 0)
+            dev.direction = -1;
+        else
+            dev.settled = true;
+    }
+
+    dev.probe = dev.current;
+    reserveBuffers(dev.current);
+}
+
+void ChunkTuner::setBufferPool(BufferPool *pool, int buffers)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pool = pool;
+    m_poolBuffers = buffers;
+}
+
+void ChunkTuner::reserveBuffers(int chunk)
+{
+    if (m_pool && m_poolBuffers > 0)
+        m_pool->setCapacity(chunk, m_poolBuffers);
+}
+
+QString ChunkTuner::summary() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList lines;
+
+    for (QHash<quint64, Device>::const_iterator it = m_devices.constBegin(); it != m_devices.constEnd(); ++it) {
+        const Device &dev = it.value();
+        const Measure measure = dev.measures.value(dev.current);
+
+        QString line = QStringLiteral(u"Read size (") + storage::deviceName(it.key()) + QStringLiteral(u"): ")
+                       + format::dataSizeReadable(dev.current);
+
+        if (measure.reads > 0) {
+            line += Lit::s_sepCommaSpace + format::processSpeed(measure.bytes, qMax<qint64>(1, measure.nsecs / 1000000))
+                    + Lit::s_sepCommaSpace + QString::number(double(measure.nsecs) / measure.reads / 1000000, 'f', 1)
+                    + QStringLiteral(u" ms per chunk");
+        }
+
+        if (!dev.settled)
+            line += QStringLiteral(u" (not settled)");
+
+        lines << line;
+    }
+
+    return lines.join('\n');
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef CHUNKTUNER_H
+#define CHUNKTUNER_H
+
+#include <QMutex>
+#include <QHash>
+#include <QMap>
+#include <QString>
+
+class BufferPool;
+
+/* Adaptive file read size, tuned separately for each device (HDD RAID, NVMe, network mounts...).
+ * The hashers report the time taken by each file read with the current size;
+ * once enough data is measured, the neighbouring sizes (x2, /2) are tried in turn,
+ * and the faster one becomes the current, until neither is better (the size is settled).
+ * Thread-safe, shared by all the hashers of a run.
+ */
+class ChunkTuner
+{
+public:
+    explicit ChunkTuner(int initialChunk = 1048576);
+
+    static const int s_minChunk = 65536;       // 64 KiB
+    static const int s_maxChunk = 16777216;    // 16 MiB
+
+    // the read size to use for the next file on the 'device'
+    int chunkSize(quint64 device);
+
+    // the file of 'bytes' was read by 'chunk' sized reads in 'nsecs'
+    void addSample(quint64 device, int chunk, qint64 bytes, qint64 nsecs);
+
+    // when a size is settled, the 'pool' keeps up to 'buffers' idle buffers of it
+    void setBufferPool(BufferPool *pool, int buffers);
+
+    // the chosen sizes: "Read size (8:16): 4 MiB, 1.2 GiB/s, 3.1 ms per chunk"
+    QString summary() const;
+
+private:
+    struct Measure {
+        qint64 bytes = 0;
+        qint64 nsecs = 0;
+        qint64 reads = 0;
+
+        double rate() const { return nsecs > 0 ? double(bytes) / nsecs : 0; }
+    }; // struct Measure
+
+    struct Device {
+        int current = 0;            // the best size found so far
+        int probe = 0;              // the size being measured
+        int direction = 1;          // 1: the larger sizes are tried, -1: the smaller ones
+        bool settled = false;
+        QMap<int, Measure> measures; // {size : measured}
+    }; // struct Device
+
+    // the measure of the probe is complete: moving on to the next size
+    void step(Device &dev);
+    void reserveBuffers(int chunk);
+
+    // the data read by the size before it is compared with the others
+    static const qint64 s_sampleBytes = 268435456; // 256 MiB
+
+    // the larger size should be faster by 5% at least
+    static constexpr double s_minGain = 1.05;
+
+    const int m_initialChunk;
+    QHash<quint64, Device> m_devices;
+
+    BufferPool *m_pool = nullptr;
+    int m_poolBuffers = 0;
+
+    mutable QMutex m_mutex;
+}; // class ChunkTuner
+
+#endif // CHUNKTUNER_H
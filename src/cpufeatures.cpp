@@ -0,0 +1,149 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "cpufeatures.h"
+#include <cstdint>
+
+#ifdef VER_ARCH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(VER_ARCH_ARM64)
+#if defined(__linux__)
+#include <sys/auxv.h>
+
+// asm/hwcap.h of arm64
+#define VER_HWCAP_SHA1 (1 << 5)
+#define VER_HWCAP_SHA2 (1 << 6)
+#define VER_HWCAP_CRC32 (1 << 7)
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+#endif
+
+#ifdef VER_ARCH_X86
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<uint32_t>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// the register states enabled by the OS (XCR0)
+static uint64_t xgetbv()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+static CpuFeatures detect()
+{
+    CpuFeatures res;
+    uint32_t regs[4]; // eax, ebx, ecx, edx
+
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+
+    if (maxLeaf < 1)
+        return res;
+
+    cpuid(1, 0, regs);
+    res.sse41 = regs[2] & (1u << 19);
+    res.sse42 = regs[2] & (1u << 20);
+
+    const bool ssse3 = regs[2] & (1u << 9);
+    const bool osxsave = regs[2] & (1u << 27);
+    const bool avx = regs[2] & (1u << 28);
+
+    if (maxLeaf < 7)
+        return res;
+
+    cpuid(7, 0, regs);
+    const uint32_t extFeatures = regs[1]; // ebx
+
+    // the SHA extensions use the XMM registers only, some CPUs have them without AVX
+    res.shaNi = ssse3 && res.sse41 && (extFeatures & (1u << 29));
+
+    if (!osxsave || !avx)
+        return res;
+
+    const uint64_t xcr0 = xgetbv();
+    const bool osAvx = (xcr0 & 0x6) == 0x6;        // XMM, YMM
+    const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;   // + opmask, ZMM
+
+    res.avx2 = osAvx && (extFeatures & (1u << 5));
+    res.avx512 = osAvx512 && (extFeatures & (1u << 16));
+
+    return res;
+}
+#elif defined(VER_ARCH_ARM64)
+static CpuFeatures detect()
+{
+    CpuFeatures res;
+
+#if defined(__APPLE__)
+    // all Apple Silicon CPUs
+    res.armSha = true;
+    res.armCrc32 = true;
+#elif defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    res.armSha = (hwcap & VER_HWCAP_SHA1) && (hwcap & VER_HWCAP_SHA2);
+    res.armCrc32 = hwcap & VER_HWCAP_CRC32;
+#elif defined(_WIN32)
+    res.armSha = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+    res.armCrc32 = IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+#endif
+
+    return res;
+}
+#else
+static CpuFeatures detect()
+{
+    return CpuFeatures();
+}
+#endif
+
+static CpuFeatures& used()
+{
+    static CpuFeatures s_features = CpuFeatures::detected();
+    return s_features;
+}
+
+const CpuFeatures& CpuFeatures::current()
+{
+    return used();
+}
+
+const CpuFeatures& CpuFeatures::detected()
+{
+    static const CpuFeatures s_features = detect();
+    return s_features;
+}
+
+void CpuFeatures::setAllowed(const CpuFeatures &allowed)
+{
+    const CpuFeatures &cpu = detected();
+    CpuFeatures &res = used();
+
+    res.sse41 = cpu.sse41 && allowed.sse41;
+    res.sse42 = cpu.sse42 && allowed.sse42;
+    res.avx2 = cpu.avx2 && allowed.avx2;
+    res.avx512 = cpu.avx512 && allowed.avx512;
+    res.shaNi = cpu.shaNi && allowed.shaNi;
+    res.armSha = cpu.armSha && allowed.armSha;
+    res.armCrc32 = cpu.armCrc32 && allowed.armCrc32;
+}
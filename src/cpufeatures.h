@@ -0,0 +1,41 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VER_ARCH_X86
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define VER_ARCH_ARM64
+#endif
+
+/* The instruction set extensions available at runtime,
+ * used to select the optimized hashing kernels.
+ * The AVX states are also checked for being enabled by the OS.
+ */
+struct CpuFeatures {
+    bool sse41 = false;
+    bool sse42 = false;      // the CRC32 instruction (CRC-32C)
+    bool avx2 = false;
+    bool avx512 = false;     // AVX-512 F
+    bool shaNi = false;      // x86 SHA extensions (SHA-1, SHA-256), along with SSSE3 and SSE4.1
+    bool armSha = false;     // ARMv8 Cryptography Extensions: SHA1 and SHA2 (SHA-256)
+    bool armCrc32 = false;   // ARMv8 CRC32 instructions (CRC-32C)
+
+    // the ones used: detected once, on first call, and not restricted (::setAllowed)
+    static const CpuFeatures& current();
+
+    // the ones of this CPU
+    static const CpuFeatures& detected();
+
+    // restricts the ones used to the 'allowed' (e.g. all false: the portable kernels);
+    // for the tests of each kernel, not while hashing
+    static void setAllowed(const CpuFeatures &allowed);
+}; // struct CpuFeatures
+
+#endif // CPUFEATURES_H
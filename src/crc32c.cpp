@@ -0,0 +1,181 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "crc32c.h"
+#include "crc32c_p.h"
+
+using namespace crc32c;
+
+namespace {
+
+using UpdateFunc = uint32_t (*)(uint32_t crc, const uint8_t *data, size_t length);
+
+// the byte-wise tables of the software crc: [k][n] is the crc of the byte 'n' followed by 'k' zero bytes
+struct SliceTables {
+    uint32_t table[8][256];
+
+    SliceTables()
+    {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t crc = n;
+
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ k_poly : (crc >> 1);
+
+            table[0][n] = crc;
+        }
+
+        for (uint32_t n = 0; n < 256; ++n) {
+            for (int k = 1; k < 8; ++k)
+                table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xFF];
+        }
+    }
+}; // struct SliceTables
+
+const SliceTables& sliceTables()
+{
+    static const SliceTables s_tables;
+    return s_tables;
+}
+
+// slicing-by-8
+uint32_t updateTables(uint32_t crc, const uint8_t *data, size_t length)
+{
+    const SliceTables &t = sliceTables();
+
+    for (; length >= 8; length -= 8, data += 8) {
+        const uint64_t value = load64(data) ^ crc;
+
+        crc = t.table[7][value & 0xFF] ^ t.table[6][(value >> 8) & 0xFF]
+              ^ t.table[5][(value >> 16) & 0xFF] ^ t.table[4][(value >> 24) & 0xFF]
+              ^ t.table[3][(value >> 32) & 0xFF] ^ t.table[2][(value >> 40) & 0xFF]
+              ^ t.table[1][(value >> 48) & 0xFF] ^ t.table[0][value >> 56];
+    }
+
+    while (length-- > 0)
+        crc = (crc >> 8) ^ t.table[0][(crc ^ *data++) & 0xFF];
+
+    return crc;
+}
+
+// the operator of 'length' zero bytes: the zeros appended to each single bit, combined by linearity
+ShiftTable makeShift(size_t length)
+{
+    const SliceTables &t = sliceTables();
+    uint32_t bits[32];
+
+    for (int i = 0; i < 32; ++i) {
+        uint32_t crc = uint32_t(1) << i;
+
+        for (size_t n = 0; n < length; ++n)
+            crc = (crc >> 8) ^ t.table[0][crc & 0xFF];
+
+        bits[i] = crc;
+    }
+
+    ShiftTable op;
+
+    for (int k = 0; k < 4; ++k) {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t res = 0;
+
+            for (int bit = 0; bit < 8; ++bit) {
+                if (n & (1u << bit))
+                    res ^= bits[k * 8 + bit];
+            }
+
+            op.table[k][n] = res;
+        }
+    }
+
+    return op;
+}
+
+UpdateFunc kernel()
+{
+#ifdef VER_ARCH_X86
+    if (CpuFeatures::current().sse42)
+        return updateSse42;
+#endif
+
+#ifdef VER_ARCH_ARM64
+    if (CpuFeatures::current().armCrc32)
+        return updateArmv8;
+#endif
+
+    return updateTables;
+}
+
+} // namespace
+
+namespace crc32c {
+
+const ShiftTable& longShift()
+{
+    static const ShiftTable s_op = makeShift(k_longLen);
+    return s_op;
+}
+
+const ShiftTable& shortShift()
+{
+    static const ShiftTable s_op = makeShift(k_shortLen);
+    return s_op;
+}
+
+} // namespace crc32c
+
+void Crc32c::reset()
+{
+    m_crc = 0xFFFFFFFF;
+}
+
+void Crc32c::update(const void *data, size_t length)
+{
+    m_crc = kernel()(m_crc, static_cast<const uint8_t*>(data), length);
+}
+
+void Crc32c::finalize(uint8_t *out) const
+{
+    const uint32_t crc = ~m_crc;
+
+    out[0] = static_cast<uint8_t>(crc >> 24);
+    out[1] = static_cast<uint8_t>(crc >> 16);
+    out[2] = static_cast<uint8_t>(crc >> 8);
+    out[3] = static_cast<uint8_t>(crc);
+}
+
+void Crc32c::saveState(std::vector<uint8_t> &out) const
+{
+    out.clear();
+
+    for (size_t i = 0; i < 4; ++i)
+        out.push_back(static_cast<uint8_t>(m_crc >> (i * 8)));
+}
+
+bool Crc32c::loadState(const uint8_t *data, size_t length)
+{
+    if (length != 4)
+        return false;
+
+    m_crc = static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8)
+            | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+
+    return true;
+}
+
+const char* Crc32c::engineName()
+{
+#ifdef VER_ARCH_X86
+    if (CpuFeatures::current().sse42)
+        return "SSE4.2";
+#endif
+
+#ifdef VER_ARCH_ARM64
+    if (CpuFeatures::current().armCrc32)
+        return "ARMv8 CRC32";
+#endif
+
+    return "Tables";
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/* CRC-32C (Castagnoli): a fast non-cryptographic checksum of the fast verification tier (Algo::Crc32c).
+ * It detects any accidental change of the data (bit rot, a bad copy), but not a deliberate one.
+ * Computed by the CRC32 instructions of the CPU (SSE4.2, ARMv8 CRC32), three streams interleaved;
+ * otherwise by the tables (slicing-by-8).
+ */
+class Crc32c
+{
+public:
+    void reset();
+    void update(const void *data, size_t length);
+
+    // writes the 4 bytes of the digest (big-endian, as the checksum is usually shown)
+    void finalize(uint8_t *out) const;
+
+    // the intermediate state to continue the hashing from later (e.g. a grown file); the same on all CPUs
+    void saveState(std::vector<uint8_t> &out) const;
+
+    // returns false if the 'data' is not a saved state, the current one is kept then
+    bool loadState(const uint8_t *data, size_t length);
+
+    // "SSE4.2", "ARMv8 CRC32" or "Tables"
+    static const char* engineName();
+
+    static constexpr size_t k_outLen = 4;
+
+private:
+    uint32_t m_crc = 0xFFFFFFFF; // inverted
+}; // class Crc32c
+
+#endif // CRC32C_H
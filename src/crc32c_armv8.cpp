@@ -0,0 +1,36 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "crc32c_p.h"
+
+#ifdef VER_ARCH_ARM64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+
+namespace crc32c {
+namespace {
+struct Armv8 {
+    static inline uint32_t u64(uint32_t crc, uint64_t value)
+    {
+        return __crc32cd(crc, value);
+    }
+
+    static inline uint32_t u8(uint32_t crc, uint8_t value)
+    {
+        return __crc32cb(crc, value);
+    }
+}; // struct Armv8
+} // namespace
+
+uint32_t updateArmv8(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return interleaved<Armv8>(crc, data, length);
+}
+
+} // namespace crc32c
+#endif // VER_ARCH_ARM64
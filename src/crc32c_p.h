@@ -0,0 +1,107 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef CRC32C_P_H
+#define CRC32C_P_H
+
+/* CRC-32C internals shared by the common code (crc32c.cpp)
+ * and the hardware kernels (crc32c_sse42.cpp, crc32c_armv8.cpp).
+ * Each kernel file is compiled with its own instruction set flags.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "cpufeatures.h"
+
+namespace crc32c {
+
+// reflected
+static constexpr uint32_t k_poly = 0x82F63B78;
+
+// the lengths of the three interleaved streams: the long ones for the bulk, the short ones for the rest
+static constexpr size_t k_longLen = 8192;
+static constexpr size_t k_shortLen = 256;
+
+/* The operator of appending the 'length' zero bytes to the (raw) crc, by the bytes of the crc.
+ * The crc of the stream that precedes another one is shifted by its length and combined with it.
+ */
+struct ShiftTable {
+    uint32_t table[4][256];
+};
+
+const ShiftTable& longShift();  // k_longLen
+const ShiftTable& shortShift(); // k_shortLen
+
+inline uint32_t shift(const ShiftTable &op, uint32_t crc)
+{
+    return op.table[0][crc & 0xFF] ^ op.table[1][(crc >> 8) & 0xFF]
+           ^ op.table[2][(crc >> 16) & 0xFF] ^ op.table[3][crc >> 24];
+}
+
+inline uint64_t load64(const uint8_t *p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value; // little-endian: the CRC takes the bytes in memory order
+}
+
+/* The raw crc of the data by the CRC32 instructions of 'Ops' (::u64, ::u8).
+ * A single stream is bound by the latency of the instruction (3 cycles),
+ * so three independent streams are computed at once and combined (::shift).
+ */
+template <typename Ops>
+inline uint32_t interleaved(uint32_t crc, const uint8_t *data, size_t length)
+{
+    // the bytes up to 8-byte alignment
+    while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7)) {
+        crc = Ops::u8(crc, *data++);
+        --length;
+    }
+
+    auto streams = [&](size_t len, const ShiftTable &op) {
+        while (length >= len * 3) {
+            uint32_t crc1 = 0;
+            uint32_t crc2 = 0;
+            const uint8_t *end = data + len;
+
+            do {
+                crc = Ops::u64(crc, load64(data));
+                crc1 = Ops::u64(crc1, load64(data + len));
+                crc2 = Ops::u64(crc2, load64(data + len * 2));
+                data += 8;
+            } while (data < end);
+
+            crc = shift(op, crc) ^ crc1;
+            crc = shift(op, crc) ^ crc2;
+            data += len * 2;
+            length -= len * 3;
+        }
+    }; // lambda streams
+
+    streams(k_longLen, longShift());
+    streams(k_shortLen, shortShift());
+
+    for (; length >= 8; length -= 8, data += 8)
+        crc = Ops::u64(crc, load64(data));
+
+    while (length-- > 0)
+        crc = Ops::u8(crc, *data++);
+
+    return crc;
+}
+
+// the kernels: the raw (inverted) crc of the 'data' appended to the 'crc'
+#ifdef VER_ARCH_X86
+uint32_t updateSse42(uint32_t crc, const uint8_t *data, size_t length);
+#endif
+
+#ifdef VER_ARCH_ARM64
+uint32_t updateArmv8(uint32_t crc, const uint8_t *data, size_t length);
+#endif
+
+} // namespace crc32c
+
+#endif // CRC32C_P_H
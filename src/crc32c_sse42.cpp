@@ -0,0 +1,37 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "crc32c_p.h"
+
+#ifdef VER_ARCH_X86
+#include <nmmintrin.h>
+
+namespace crc32c {
+namespace {
+struct Sse42 {
+    static inline uint32_t u64(uint32_t crc, uint64_t value)
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return static_cast<uint32_t>(_mm_crc32_u64(crc, value));
+#else
+        crc = _mm_crc32_u32(crc, static_cast<uint32_t>(value));
+        return _mm_crc32_u32(crc, static_cast<uint32_t>(value >> 32));
+#endif
+    }
+
+    static inline uint32_t u8(uint32_t crc, uint8_t value)
+    {
+        return _mm_crc32_u8(crc, value);
+    }
+}; // struct Sse42
+} // namespace
+
+uint32_t updateSse42(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return interleaved<Sse42>(crc, data, length);
+}
+
+} // namespace crc32c
+#endif // VER_ARCH_X86
@@ -162,6 +162,16 @@ bool DataHelper::isImmutable(const DataContainer *data)
     return (data->m_metadata.flags & MetaData::FlagConst);
 }
 
+bool DataHelper::hasSampleDigests(const DataContainer *data)
+{
+    return (data->m_metadata.flags & MetaData::FlagSamples);
+}
+
+bool DataHelper::hasBlockDigests(const DataContainer *data)
+{
+    return (data->m_metadata.flags & MetaData::FlagBlocks);
+}
+
 bool DataHelper::hasPossiblyMovedItems(const DataContainer *data)
 {
     return contains(data, FileStatus::New) && contains(data, FileStatus::Missing);
@@ -18,6 +18,7 @@ class TreeModel;
 
 struct MetaData {
     QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256;
+    QList<QCryptographicHash::Algorithm> extraAlgorithms; // multi-digest db: hashed in the same pass as the main one
     QString workDir;      // current working folder
     QString dbFilePath;   // path to the db file
     QString comment;      // custom comment string/text
@@ -25,10 +26,16 @@ struct MetaData {
     FilterRule filter;    // file filtering rules for the current database
     VerDateTime datetime; // time stamps: date and time of creation, update, verification
 
+    // multi-digest db verified by the fastest digest: the last verification by the main algorithm,
+    // "yyyy/MM/dd HH:mm" (Settings::verify_full_days)
+    QString fullCheck;
+
     enum DbFileState : quint8 { NoFile, Created, NotSaved, Saved };
     DbFileState dbFileState = NoFile;
 
-    enum PropertyFlag : quint8 { NotSet = 0, FlagConst = 1 };
+    // FlagSamples: the sample digests of large files are stored (spot-checks)
+    // FlagBlocks: ... the block digests (the changed parts of a mismatched file)
+    enum PropertyFlag : quint8 { NotSet = 0, FlagConst = 1, FlagSamples = 1 << 1, FlagBlocks = 1 << 2 };
     quint8 flags = NotSet;
 }; // struct MetaData
 
@@ -97,6 +104,12 @@ struct DataHelper {
     // has FlagConst
     static bool isImmutable(const DataContainer *data);
 
+    // has FlagSamples
+    static bool hasSampleDigests(const DataContainer *data);
+
+    // has FlagBlocks
+    static bool hasBlockDigests(const DataContainer *data);
+
     // has New and Missing
     static bool hasPossiblyMovedItems(const DataContainer *data);
 
@@ -12,6 +12,8 @@
 #include "pathstr.h"
 #include "backupfile.h"
 #include "digeststring.h"
+#include "algostring.h"
+#include "tailstate.h"
 
 DataMaintainer::DataMaintainer(QObject *parent)
     : QObject(parent)
@@ -115,6 +117,14 @@ void DataMaintainer::updateVerifDateTime()
     }
 }
 
+void DataMaintainer::updateFullCheckDateTime()
+{
+    if (m_data && !m_data->m_metadata.extraAlgorithms.isEmpty()) {
+        m_data->m_metadata.fullCheck = format::currentDateTime();
+        setDbFileState(DbFileState::NotSaved);
+    }
+}
+
 void DataMaintainer::checkVerifDateTime()
 {
     if (!m_data || !m_data->m_metadata.datetime.hasValue(VerDateTime::Verified))
@@ -256,6 +266,78 @@ bool DataMaintainer::updateChecksum(const QModelIndex &fileRowIndex, const QStri
     }
 }
 
+bool DataMaintainer::updateChecksum(const QModelIndex &fileRowIndex, const QString &computedChecksum,
+                                    QCryptographicHash::Algorithm algo)
+{
+    if (!m_data || algo == m_data->m_metadata.algorithm)
+        return updateChecksum(fileRowIndex, computedChecksum);
+
+    const QString storedChecksum = TreeModel::itemFileExtraChecksum(fileRowIndex, algo);
+
+    if (storedChecksum.isEmpty()) {
+        qDebug() << "DM::updateChecksum >> No stored digest:" << AlgoString::name(algo);
+        return false;
+    }
+
+    // the ReChecksum column is for the main algorithm only, so nothing to update the db with
+    const bool isMatched = (storedChecksum == computedChecksum);
+    setFileStatus(fileRowIndex, isMatched ? FileStatus::Matched : FileStatus::Mismatched);
+
+    return isMatched;
+}
+
+void DataMaintainer::setSampleChecksum(const QModelIndex &fileIndex, const QString &checksum)
+{
+    if (!checksum.isEmpty())
+        setItemValue(fileIndex, Column::ColumnSampleChecksum, checksum);
+}
+
+void DataMaintainer::setBlockChecksums(const QModelIndex &fileIndex, const QString &blocks)
+{
+    if (!blocks.isEmpty())
+        setItemValue(fileIndex, Column::ColumnBlockChecksums, blocks);
+}
+
+void DataMaintainer::setChangedBlocks(const QModelIndex &fileIndex, const QList<int> &blocks)
+{
+    if (blocks.isEmpty()) {
+        if (fileIndex.siblingAtColumn(Column::ColumnChangedBlocks).data(TreeModel::RawDataRole).isValid())
+            setItemValue(fileIndex, Column::ColumnChangedBlocks);
+        return;
+    }
+
+    QVariantList list;
+    for (const int block : blocks)
+        list << block;
+
+    setItemValue(fileIndex, Column::ColumnChangedBlocks, list);
+}
+
+bool DataMaintainer::setFingerprint(const QModelIndex &fileIndex, const QString &fingerprint)
+{
+    if (fingerprint.isEmpty() || fingerprint == TreeModel::itemFileFingerprint(fileIndex))
+        return false;
+
+    setItemValue(fileIndex, Column::ColumnFingerprint, fingerprint);
+    return true;
+}
+
+bool DataMaintainer::setTailState(const QModelIndex &fileIndex, const QString &tail)
+{
+    if (tail.isEmpty() || tail == TreeModel::itemFileTailState(fileIndex))
+        return false;
+
+    setItemValue(fileIndex, Column::ColumnTailState, tail);
+    return true;
+}
+
+void DataMaintainer::setExtraChecksums(const QModelIndex &fileIndex,
+                                       const QMap<QCryptographicHash::Algorithm, QString> &checksums)
+{
+    if (!checksums.isEmpty())
+        setItemValue(fileIndex, Column::ColumnExtraChecksums, TreeModel::extraChecksumsValue(checksums));
+}
+
 bool DataMaintainer::importChecksum(const QModelIndex &file, const QString &checksum)
 {
     // checking for compliance with the current algo
@@ -301,6 +383,23 @@ int DataMaintainer::addToQueue(const FileStatuses statuses, const QModelIndex &r
 void DataMaintainer::clearChecksum(const QModelIndex &fileIndex)
 {
     setItemValue(fileIndex, Column::ColumnChecksum);
+
+    if (fileIndex.siblingAtColumn(Column::ColumnExtraChecksums).data(TreeModel::RawDataRole).isValid())
+        setItemValue(fileIndex, Column::ColumnExtraChecksums);
+
+    if (fileIndex.siblingAtColumn(Column::ColumnSampleChecksum).data(TreeModel::RawDataRole).isValid())
+        setItemValue(fileIndex, Column::ColumnSampleChecksum);
+
+    if (fileIndex.siblingAtColumn(Column::ColumnFingerprint).data(TreeModel::RawDataRole).isValid())
+        setItemValue(fileIndex, Column::ColumnFingerprint);
+
+    if (fileIndex.siblingAtColumn(Column::ColumnBlockChecksums).data(TreeModel::RawDataRole).isValid())
+        setItemValue(fileIndex, Column::ColumnBlockChecksums);
+
+    if (fileIndex.siblingAtColumn(Column::ColumnTailState).data(TreeModel::RawDataRole).isValid())
+        setItemValue(fileIndex, Column::ColumnTailState);
+
+    setChangedBlocks(fileIndex, QList<int>());
 }
 
 int DataMaintainer::clearChecksums(const FileStatuses statuses, const QModelIndex &rootIndex)
@@ -315,7 +414,7 @@ int DataMaintainer::clearChecksums(const FileStatuses statuses, const QModelInde
 
     while (iter.hasNext()) {
         if (statuses & iter.nextFile().status()) {
-            setItemValue(iter.index(), Column::ColumnChecksum);
+            clearChecksum(iter.index());
             ++number;
         }
     }
@@ -383,6 +482,12 @@ bool DataMaintainer::tryMoved(const QModelIndex &file, const QString &checksum)
     const FileStatus status = TreeModel::itemFileStatus(ind_movedout);
 
     if (status & (FileStatus::Missing | FileStatus::Removed)) {
+        const QVariant extraChecksums = ind_movedout.siblingAtColumn(Column::ColumnExtraChecksums).data(TreeModel::RawDataRole);
+        const QVariant sampleChecksum = ind_movedout.siblingAtColumn(Column::ColumnSampleChecksum).data(TreeModel::RawDataRole);
+        const QVariant fingerprint = ind_movedout.siblingAtColumn(Column::ColumnFingerprint).data(TreeModel::RawDataRole);
+        const QVariant blocks = ind_movedout.siblingAtColumn(Column::ColumnBlockChecksums).data(TreeModel::RawDataRole);
+        const QVariant tail = ind_movedout.siblingAtColumn(Column::ColumnTailState).data(TreeModel::RawDataRole);
+
         clearChecksum(ind_movedout);
         setFileStatus(ind_movedout, FileStatus::MovedOut);
         m_data->m_numbers.moveFile(status, FileStatus::MovedOut);
@@ -390,6 +495,17 @@ bool DataMaintainer::tryMoved(const QModelIndex &file, const QString &checksum)
         // moved
         setFileStatus(file, FileStatus::Moved);
         setItemValue(file, Column::ColumnChecksum, checksum);
+
+        if (extraChecksums.isValid())
+            setItemValue(file, Column::ColumnExtraChecksums, extraChecksums);
+        if (sampleChecksum.isValid())
+            setItemValue(file, Column::ColumnSampleChecksum, sampleChecksum);
+        if (fingerprint.isValid())
+            setItemValue(file, Column::ColumnFingerprint, fingerprint);
+        if (blocks.isValid())
+            setItemValue(file, Column::ColumnBlockChecksums, blocks);
+        if (tail.isValid())
+            setItemValue(file, Column::ColumnTailState, tail);
         return true;
     }
 
@@ -425,6 +541,18 @@ bool DataMaintainer::itemFileUpdateChecksum(const QModelIndex &fileIndex)
         const QString reChecksum = TreeModel::itemFileReChecksum(fileIndex);
 
         if (!reChecksum.isEmpty()) {
+            // the extra, sample and block digests (if any) were computed for the previous file contents;
+            // the file may have been changed again since the recheck, so no fingerprint until the next match
+            setItemValue(fileIndex, Column::ColumnExtraChecksums);
+            setItemValue(fileIndex, Column::ColumnSampleChecksum);
+            setItemValue(fileIndex, Column::ColumnBlockChecksums);
+            setItemValue(fileIndex, Column::ColumnFingerprint);
+            setChangedBlocks(fileIndex, QList<int>());
+
+            // the state computed along with the new checksum is kept: the next growth is hashed from it
+            if (TailState::fromString(TreeModel::itemFileTailState(fileIndex)).digest() != reChecksum)
+                setItemValue(fileIndex, Column::ColumnTailState);
+
             setItemValue(fileIndex, Column::ColumnChecksum, reChecksum);
             setItemValue(fileIndex, Column::ColumnReChecksum);
             setItemValue(fileIndex, Column::ColumnStatus, FileStatus::Updated);
@@ -503,6 +631,8 @@ MetaData DataMaintainer::getMetaData(const VerJson &json) const
 
     // [algorithm]
     meta.algorithm = json.algorithm();
+    meta.extraAlgorithms = json.extraAlgorithms();
+    meta.extraAlgorithms.removeAll(meta.algorithm);
 
     // [datetime] version 0.4.0+
     QString strDateTime = json.getInfo(QStringLiteral(u"time"));
@@ -523,10 +653,17 @@ MetaData DataMaintainer::getMetaData(const VerJson &json) const
 
     meta.datetime.set(strDateTime);
 
+    if (!meta.extraAlgorithms.isEmpty())
+        meta.fullCheck = json.getInfo(VerJson::h_key_FullCheck);
+
     // [flags]
     const QString strFlags = json.getInfo(VerJson::h_key_Flags);
     if (strFlags.contains(QStringLiteral(u"const")))
         meta.flags |= MetaData::FlagConst;
+    if (strFlags.contains(QStringLiteral(u"samples")))
+        meta.flags |= MetaData::FlagSamples;
+    if (strFlags.contains(QStringLiteral(u"blocks")))
+        meta.flags |= MetaData::FlagBlocks;
 
     // [comment]
     meta.comment = json.getInfo(VerJson::h_key_Comment);
@@ -556,6 +693,15 @@ TreeModel* DataMaintainer::makeModel(const VerJson &json, const MetaData &meta)
     const QString basicDate = m_considerFileModDate ? meta.datetime.basicDate() : QString();
     const QJsonObject &itemList = json.items(); // { file_path : checksum }
 
+    QList<QPair<QCryptographicHash::Algorithm, QJsonObject>> extraLists; // multi-digest db
+    for (const QCryptographicHash::Algorithm algo : meta.extraAlgorithms)
+        extraLists.append({ algo, json.extraItems(algo) });
+
+    const QJsonObject &sampleList = json.sampleItems(); // { file_path : sample checksum }
+    const QJsonObject &fingerprintList = json.fingerprintItems(); // { file_path : "size:mtime:inode" }
+    const QJsonObject &blockList = json.blockItems(); // { file_path : "block size:digests" }
+    const QJsonObject &tailList = json.tailItems(); // { file_path : "size:digest:edges:state" }
+
     for (QJsonObject::const_iterator it = itemList.constBegin();
          !isCanceled() && it != itemList.constEnd(); ++it)
     {
@@ -563,6 +709,24 @@ TreeModel* DataMaintainer::makeModel(const VerJson &json, const MetaData &meta)
         FileValues values = makeFileValues(fullPath, basicDate);
         values.checksum = it.value().toString();
 
+        for (const QPair<QCryptographicHash::Algorithm, QJsonObject> &extra : std::as_const(extraLists)) {
+            const QJsonValue extraSum = extra.second.value(it.key());
+            if (extraSum.isString())
+                values.extraChecksums[extra.first] = extraSum.toString();
+        }
+
+        if (!sampleList.isEmpty())
+            values.sampleChecksum = sampleList.value(it.key()).toString();
+
+        if (!fingerprintList.isEmpty())
+            values.fingerprint = fingerprintList.value(it.key()).toString();
+
+        if (!blockList.isEmpty())
+            values.blockChecksums = blockList.value(it.key()).toString();
+
+        if (!tailList.isEmpty())
+            values.tailState = tailList.value(it.key()).toString();
+
         pModel->add_file(it.key(), values);
     }
 
@@ -678,6 +842,13 @@ VerJson* DataMaintainer::makeJson(const QModelIndex &rootFolder)
                                                                               : meta.datetime.toString();
     pJson->addInfo(VerJson::h_key_DateTime, timestamp);
 
+    // Algorithm (can't always be determined by the digest length)
+    pJson->addInfo(VerJson::h_key_Algo, AlgoString::name(meta.algorithm));
+
+    // the last verification by the main algorithm of a multi-digest db
+    if (!isBranching && !meta.extraAlgorithms.isEmpty() && !meta.fullCheck.isEmpty())
+        pJson->addInfo(VerJson::h_key_FullCheck, meta.fullCheck);
+
     // WorkDir
     if (!isBranching && !DataHelper::isWorkDirRelative(m_data))
         pJson->addInfo(VerJson::h_key_WorkDir, meta.workDir);
@@ -689,9 +860,17 @@ VerJson* DataMaintainer::makeJson(const QModelIndex &rootFolder)
         pJson->addInfo(h_key, meta.filter.extensionString());
     }
 
-    // Flags (needs to be reimplement after expanding the flags list)
-    if (meta.flags)
-        pJson->addInfo(VerJson::h_key_Flags, QStringLiteral(u"const"));
+    // Flags
+    QStringList flags;
+    if (meta.flags & MetaData::FlagConst)
+        flags << QStringLiteral(u"const");
+    if (meta.flags & MetaData::FlagSamples)
+        flags << QStringLiteral(u"samples");
+    if (meta.flags & MetaData::FlagBlocks)
+        flags << QStringLiteral(u"blocks");
+
+    if (!flags.isEmpty())
+        pJson->addInfo(VerJson::h_key_Flags, flags.join(Lit::s_sepCommaSpace));
 
     // Comment
     if (!meta.comment.isEmpty())
@@ -700,13 +879,40 @@ VerJson* DataMaintainer::makeJson(const QModelIndex &rootFolder)
     /*** Main data ***/
     emit setStatusbarText(QStringLiteral(u"Exporting data to json..."));
 
+    const bool hasExtraDigests = !meta.extraAlgorithms.isEmpty();
     TreeModelIterator iter(m_data->m_model, rootFolder);
 
     while (iter.hasNext() && !isCanceled()) {
         iter.nextFile();
         const QString checksum = iter.checksum();
         if (!checksum.isEmpty()) {
-            pJson->addItem(iter.path(rootFolder), checksum);
+            const QString path = iter.path(rootFolder);
+            pJson->addItem(path, checksum);
+
+            if (hasExtraDigests) {
+                const QMap<QCryptographicHash::Algorithm, QString> extra = TreeModel::itemFileExtraChecksums(iter.index());
+                QMap<QCryptographicHash::Algorithm, QString>::const_iterator it;
+
+                for (it = extra.constBegin(); it != extra.constEnd(); ++it)
+                    pJson->addExtraItem(it.key(), path, it.value());
+            }
+
+            const QString sample = TreeModel::itemFileSampleChecksum(iter.index());
+            if (!sample.isEmpty())
+                pJson->addSampleItem(path, sample);
+
+            const QString fingerprint = TreeModel::itemFileFingerprint(iter.index());
+            if (!fingerprint.isEmpty())
+                pJson->addFingerprintItem(path, fingerprint);
+
+            const QString blocks = TreeModel::itemFileBlockChecksums(iter.index());
+            if (!blocks.isEmpty())
+                pJson->addBlocksItem(path, blocks);
+
+            // the state of another contents (a mismatch not updated) is of no use
+            const QString tail = TreeModel::itemFileTailState(iter.index());
+            if (!tail.isEmpty() && TailState::fromString(tail).digest() == checksum)
+                pJson->addTailItem(path, tail);
         }
         else if (iter.status() & FileStatus::CombUnreadable) {
             pJson->addItemUnr(iter.path(rootFolder));
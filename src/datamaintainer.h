@@ -38,6 +38,9 @@ public:
     void updateDateTime();
     void updateVerifDateTime();
 
+    // the entire multi-digest db has been verified by the main algorithm (MetaData::fullCheck)
+    void updateFullCheckDateTime();
+
     /* Checking a verification time stamp for obsolescence.
      * The 'Verified' time stamp will be considered outdated if among the available files
      * there are those that were created later. (files were copied)
@@ -57,6 +60,29 @@ public:
     bool updateChecksum(const QModelIndex &fileRowIndex,
                         const QString &computedChecksum);
 
+    // ... the 'computedChecksum' of the 'algo', which may be one of the extra algorithms of the database
+    bool updateChecksum(const QModelIndex &fileRowIndex,
+                        const QString &computedChecksum,
+                        QCryptographicHash::Algorithm algo);
+
+    // sets the digests of the extra algorithms (multi-digest database)
+    void setExtraChecksums(const QModelIndex &fileIndex,
+                           const QMap<QCryptographicHash::Algorithm, QString> &checksums);
+    void setSampleChecksum(const QModelIndex &fileIndex, const QString &checksum);
+
+    // BlockList::toString
+    void setBlockChecksums(const QModelIndex &fileIndex, const QString &blocks);
+
+    // the blocks found changed by the verification; empty: clears
+    void setChangedBlocks(const QModelIndex &fileIndex, const QList<int> &blocks);
+
+    // the file state at the last match; returns true if the stored one has been changed
+    bool setFingerprint(const QModelIndex &fileIndex, const QString &fingerprint);
+
+    // the hash state at the end of the file (TailState::toString), of the checksum or the re-computed one;
+    // returns true if the stored one has been changed
+    bool setTailState(const QModelIndex &fileIndex, const QString &tail);
+
     bool importChecksum(const QModelIndex &file,
                         const QString &checksum);
 
@@ -69,7 +95,7 @@ public:
     int addToQueue(const FileStatuses statuses,
                    const QModelIndex &rootIndex = QModelIndex());
 
-    // clears stored checksum string, single file item
+    // clears stored checksum string (and the extra digests), single file item
     void clearChecksum(const QModelIndex &fileIndex);
 
     // ... for all items with given statuses, returns done number
@@ -123,6 +123,8 @@ void DialogDbCreation::updateSettings()
     m_settings->addWorkDirToFilename = ui->cb_add_folder_name->isChecked();
     m_settings->dbFlagConst = ui->cb_flag_const->isChecked();
     m_settings->m_importSumsWhenItemAdding = ui->cbImportWhenAdding->isChecked();
+    m_settings->dbFlagSamples = ui->cbSampleDigests->isChecked();
+    m_settings->dbFlagBlocks = ui->cbBlockDigests->isChecked();
 
     // filter
     m_settings->filter_editable_exts = ui->cb_editable_exts->isChecked();
@@ -145,6 +147,8 @@ void DialogDbCreation::setDbConfig()
     ui->cb_add_folder_name->setChecked(m_settings->addWorkDirToFilename);
     ui->cb_flag_const->setChecked(m_settings->dbFlagConst);
     ui->cbImportWhenAdding->setChecked(m_settings->m_importSumsWhenItemAdding);
+    ui->cbSampleDigests->setChecked(m_settings->dbFlagSamples);
+    ui->cbBlockDigests->setChecked(m_settings->dbFlagBlocks);
 
     if (!m_settings->dbPrefix.isEmpty() && (m_settings->dbPrefix != Lit::s_db_prefix))
         ui->inp_db_prefix->setText(m_settings->dbPrefix);
@@ -156,6 +160,8 @@ void DialogDbCreation::setDbConfig()
     ui->cmb_algo->addItem(AlgoString::name(QCryptographicHash::Sha1));
     ui->cmb_algo->addItem(AlgoString::name(QCryptographicHash::Sha256));
     ui->cmb_algo->addItem(AlgoString::name(QCryptographicHash::Sha512));
+    ui->cmb_algo->addItem(AlgoString::name(Algo::Blake3));
+    ui->cmb_algo->addItem(AlgoString::name(Algo::Crc32c)); // a checksum only, for the bit rot
     ui->cmb_algo->setCurrentIndex(cmbAlgoIndex());
 }
 
@@ -171,6 +177,10 @@ int DialogDbCreation::cmbAlgoIndex()
         return 1;
     case QCryptographicHash::Sha512:
         return 2;
+    case Algo::Blake3:
+        return 3;
+    case Algo::Crc32c:
+        return 4;
     default:
         return 1;
     }
@@ -171,7 +171,10 @@ QStringList DialogDbStatus::infoVerification()
     const int n_available = num.numberOf(FileStatus::CombAvailable);
     const int n_mismatch = num.numberOf(FileStatus::Mismatched);
 
-    if (DataHelper::isAllChecked(m_data)) {
+    // the partial checks (spot, incremental) are detailed below, not reported as all matched
+    if (DataHelper::isAllChecked(m_data)
+        && !num.contains(FileStatus::SampleMatched | FileStatus::Unchanged))
+    {
         const int n_checksums = num.numberOf(FileStatus::CombHasChecksum);
 
         if (n_mismatch) {
@@ -207,6 +210,14 @@ QStringList DialogDbStatus::infoVerification()
                               .arg(n_matched)
                               .arg(n_added_updated > 0 ? format::inParentheses(n_matched + n_added_updated) : QString()));
         }
+
+        const int n_sampled = num.numberOf(FileStatus::SampleMatched);
+        if (n_sampled)
+            result.append(format::filesNumber(n_sampled) + QStringLiteral(u" matched by a sample (spot-check)"));
+
+        const int n_unchanged = num.numberOf(FileStatus::Unchanged);
+        if (n_unchanged)
+            result.append(format::filesNumber(n_unchanged) + QStringLiteral(u" unchanged since the last match (not read)"));
     }
 
     return result;
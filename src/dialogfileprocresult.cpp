@@ -9,6 +9,8 @@
 #include "pathstr.h"
 #include "algostring.h"
 #include "digeststring.h"
+#include "blocklist.h"
+#include "hashfunction.h"
 #include <QPushButton>
 #include <QFile>
 #include <QClipboard>
@@ -74,8 +76,17 @@ void DialogFileProcResult::setModeMismatched()
     QTextEdit *reChecksum = new QTextEdit(this);
     reChecksum->setReadOnly(true);
     reChecksum->setMinimumHeight(45);
-    reChecksum->setTextColor(QColor("green"));
-    reChecksum->setText(values_.reChecksum);
+
+    // verified by blocks: the changed byte ranges instead of the computed checksum
+    if (values_.reChecksum.isEmpty()) {
+        reChecksum->setText(values_.changedRanges.isEmpty() ? QStringLiteral(u"The file size has changed.")
+                                                            : QStringLiteral(u"Changed bytes: ")
+                                                                  + BlockList::rangesToString(values_.changedRanges));
+    } else {
+        reChecksum->setTextColor(QColor("green"));
+        reChecksum->setText(values_.reChecksum);
+    }
+
     ui->verticalLayout->addWidget(reChecksum);
 }
 
@@ -186,8 +197,11 @@ void DialogFileProcResult::setExtLineVisible(bool visible)
     }
 
     if (hasDigest) {
+        // the implementation is known if the algorithm is
         ui->labelAlgo->setText(QStringLiteral(u"Algorithm: ")
-                               + AlgoString::name(values_.checksum.length()));
+                               + (values_.hash_algo ? AlgoString::name(values_.hash_algo)
+                                                        + QStringLiteral(u" (") + HashFunction::engineName(values_.hash_algo) + ')'
+                                                    : AlgoString::name(values_.checksum.length())));
     }
 }
 
@@ -214,7 +228,8 @@ void DialogFileProcResult::makeSumFile()
     if (filePath_.isEmpty() || !DigestString::isValid(chsum))
         return;
 
-    const QString sumFile = paths::digestFilePath(filePath_, chsum.size());
+    const QString sumFile = values_.hash_algo ? paths::digestFilePath(filePath_, values_.hash_algo)
+                                              : paths::digestFilePath(filePath_, chsum.size());
     const QString strToWrite = tools::joinStrings(chsum, pathstr::entryName(filePath_), QStringLiteral(u" *"));
 
     setFileName(sumFile);
@@ -232,6 +247,19 @@ void DialogFileProcResult::makeSumFile()
 
 void DialogFileProcResult::verify()
 {
+    // verified by blocks, there is no full checksum computed
+    if (!values_.checksum.isEmpty() && values_.reChecksum.isEmpty()) {
+        if (values_.status == FileStatus::Matched) {
+            setModeMatched();
+            return;
+        }
+
+        if (values_.status == FileStatus::Mismatched) {
+            setModeMismatched();
+            return;
+        }
+    }
+
     if (values_.checksum.isEmpty() || values_.reChecksum.isEmpty()) {
         setWindowTitle("not enough data!");
         return;
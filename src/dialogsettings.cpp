@@ -8,6 +8,8 @@
 #include <QPushButton>
 #include "iconprovider.h"
 #include "tools.h"
+#include "algostring.h"
+#include "mapguard.h"
 #include <QDebug>
 
 DialogSettings::DialogSettings(Settings *settings, QWidget *parent) :
@@ -32,6 +34,11 @@ DialogSettings::DialogSettings(Settings *settings, QWidget *parent) :
     ui->cbConsiderDateModified->setToolTip(QStringLiteral(u"During parsing, check the files modified date.\n"
                                                            "Items changed after creating the DB will be marked."));
 
+#ifndef Q_OS_LINUX
+    ui->labelHashingQueueDepth->setVisible(false);
+    ui->sbHashingQueueDepth->setVisible(false);
+#endif
+
     loadSettings(*settings);
 
     // set tabs icons
@@ -53,6 +60,9 @@ void DialogSettings::loadSettings(const Settings &settings)
         case QCryptographicHash::Sha512:
             ui->rbSha512->setChecked(true);
             break;
+        case Algo::Blake3:
+            ui->rbBlake3->setChecked(true);
+            break;
         default:
             break;
     }
@@ -76,6 +86,17 @@ void DialogSettings::loadSettings(const Settings &settings)
     ui->cbDbFlagConst->setChecked(settings.dbFlagConst);
     settings.isLongExtension ? ui->rbExtVerJson->setChecked(true) : ui->rbExtVer->setChecked(true);
 
+    QStringList extraAlgos;
+    for (const QCryptographicHash::Algorithm algo : settings.extra_algorithms)
+        extraAlgos << AlgoString::name(algo);
+
+    ui->inputExtraAlgorithms->setText(extraAlgos.join(Lit::s_sepCommaSpace));
+    ui->cbVerifyFastestDigest->setChecked(settings.verify_fastest_digest);
+    ui->sbVerifyFullDays->setValue(settings.verify_full_days);
+    ui->cbDbFlagSamples->setChecked(settings.dbFlagSamples);
+    ui->cbDbFlagBlocks->setChecked(settings.dbFlagBlocks);
+    ui->sbSpotCheckPercent->setValue(settings.spot_check_percent);
+
     updateLabelDatabaseFilename();
 
     // Tab Extra
@@ -83,6 +104,22 @@ void DialogSettings::loadSettings(const Settings &settings)
     ui->cbIgnoreShaFiles->setChecked(settings.filter_ignore_sha);
     ui->cbIgnoreUnpermitted->setChecked(settings.filter_ignore_unpermitted);
     ui->cbIgnoreSymlinks->setChecked(settings.filter_ignore_symlinks);
+
+    // hashing
+    ui->sbHashingThreads->setValue(settings.hashing_threads);
+    ui->cbHashingMmap->setChecked(settings.hashing_mmap);
+    ui->cbHashingMmap->setEnabled(mapguard::isAvailable()); // not used where its faults can't be caught
+    ui->cbHashingCacheFriendly->setChecked(settings.hashing_cache_friendly);
+    ui->sbHashingQueueDepth->setValue(settings.hashing_queue_depth);
+    ui->cbHashingAdaptiveChunk->setChecked(settings.hashing_adaptive_chunk);
+    ui->cbHashingPerDevice->setChecked(settings.hashing_per_device);
+    ui->cbHashingLayoutOrder->setChecked(settings.hashing_layout_order);
+    ui->cbHashingCheckpoints->setChecked(settings.hashing_checkpoints);
+    ui->cbHashingResumeGrown->setChecked(settings.hashing_resume_grown);
+    ui->cbQosIoClass->setCurrentIndex(qBound(0, settings.qos_io_class, 2));
+    ui->sbQosIoLevel->setValue(settings.qos_io_level);
+    ui->sbQosBandwidth->setValue(settings.qos_bandwidth);
+    ui->sbQosThreads->setValue(settings.qos_threads);
 }
 
 void DialogSettings::updateSettings()
@@ -94,6 +131,8 @@ void DialogSettings::updateSettings()
         settings_->setAlgorithm(QCryptographicHash::Sha256);
     else if (ui->rbSha512->isChecked())
         settings_->setAlgorithm(QCryptographicHash::Sha512);
+    else if (ui->rbBlake3->isChecked())
+        settings_->setAlgorithm(Algo::Blake3);
 
     settings_->restoreLastPathOnStartup = ui->cbLastPath->isChecked();
     settings_->instantSaving = ui->cbInstantSaving->isChecked();
@@ -111,11 +150,40 @@ void DialogSettings::updateSettings()
     settings_->saveVerificationDateTime = ui->cbSaveVerificationDateTime->isChecked();
     settings_->dbFlagConst = ui->cbDbFlagConst->isChecked();
 
+    settings_->extra_algorithms.clear();
+    const QStringList extraAlgos = ui->inputExtraAlgorithms->text().split(',', Qt::SkipEmptyParts);
+    for (const QString &strAlgo : extraAlgos) {
+        const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(strAlgo);
+        if (algo && !settings_->extra_algorithms.contains(algo))
+            settings_->extra_algorithms << algo;
+    }
+
+    settings_->verify_fastest_digest = ui->cbVerifyFastestDigest->isChecked();
+    settings_->verify_full_days = ui->sbVerifyFullDays->value();
+    settings_->dbFlagSamples = ui->cbDbFlagSamples->isChecked();
+    settings_->dbFlagBlocks = ui->cbDbFlagBlocks->isChecked();
+    settings_->spot_check_percent = ui->sbSpotCheckPercent->value();
+
     // extra filters
     settings_->filter_ignore_db = ui->cbIgnoreDbFiles->isChecked();
     settings_->filter_ignore_sha = ui->cbIgnoreShaFiles->isChecked();
     settings_->filter_ignore_unpermitted = ui->cbIgnoreUnpermitted->isChecked();
     settings_->filter_ignore_symlinks = ui->cbIgnoreSymlinks->isChecked();
+
+    // hashing
+    settings_->hashing_threads = ui->sbHashingThreads->value();
+    settings_->hashing_mmap = ui->cbHashingMmap->isChecked();
+    settings_->hashing_cache_friendly = ui->cbHashingCacheFriendly->isChecked();
+    settings_->hashing_queue_depth = ui->sbHashingQueueDepth->value();
+    settings_->hashing_adaptive_chunk = ui->cbHashingAdaptiveChunk->isChecked();
+    settings_->hashing_per_device = ui->cbHashingPerDevice->isChecked();
+    settings_->hashing_layout_order = ui->cbHashingLayoutOrder->isChecked();
+    settings_->hashing_checkpoints = ui->cbHashingCheckpoints->isChecked();
+    settings_->hashing_resume_grown = ui->cbHashingResumeGrown->isChecked();
+    settings_->qos_io_class = ui->cbQosIoClass->currentIndex();
+    settings_->qos_io_level = ui->sbQosIoLevel->value();
+    settings_->qos_bandwidth = ui->sbQosBandwidth->value();
+    settings_->qos_threads = ui->sbQosThreads->value();
 }
 
 void DialogSettings::updateLabelDatabaseFilename()
@@ -22,12 +22,19 @@ bool DigestString::isValid(QCryptographicHash::Algorithm algo) const
 
 bool DigestString::isValid(const QString &digest)
 {
+    // the short CRC32C digests are too likely to be something else, so only by the algorithm
     static const QSet<int> s_perm_length = {32, 40, 64, 128};
 
-    if (!s_perm_length.contains(digest.length())) {
-        return false;
-    }
+    return s_perm_length.contains(digest.length()) && isHex(digest);
+}
+
+bool DigestString::isValid(const QString &digest, QCryptographicHash::Algorithm algo)
+{
+    return (digest.size() == AlgoString::digestLength(algo)) && isHex(digest);
+}
 
+bool DigestString::isHex(const QString &digest)
+{
     // whether the char is a digit or a letter from 'Aa' to 'Ff'
     auto isHexChar = [](const QChar c) {
         const char ch = c.toLatin1();
@@ -45,11 +52,6 @@ bool DigestString::isValid(const QString &digest)
     return true;
 }
 
-bool DigestString::isValid(const QString &digest, QCryptographicHash::Algorithm algo)
-{
-    return (digest.size() == AlgoString::digestLength(algo)) && isValid(digest);
-}
-
 QCryptographicHash::Algorithm DigestString::algorithm() const
 {
     return algorithm(*m_digest);
@@ -26,6 +26,8 @@ public:
     explicit operator bool() const { return isValid(); }
 
 private:
+    static bool isHex(const QString &digest);
+
     const QString *m_digest;
 }; // class DigestString
 
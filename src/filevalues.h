@@ -7,6 +7,7 @@
 #define FILEVALUES_H
 
 #include <QObject>
+#include <QCryptographicHash>
 
 struct FileValues {
     Q_GADGET
@@ -42,13 +43,15 @@ public:
         MovedOut = 1 << 14,     // former Missing when moving
         UnPermitted = 1 << 15,  // no read permissions
         ReadError = 1 << 16,    // an error occurred during reading
+        SampleMatched = 1 << 17, // spot-check: only the sample of the file matched, not a full verification
+        Unchanged = 1 << 18,    // incremental check: the file state (size, mtime, inode) is the same as at the last match, not hashed
 
         CombNotChecked = NotChecked | NotCheckedMod | Imported,
-        CombAvailable = CombNotChecked | Matched | Mismatched | Added | Updated | Moved,
+        CombAvailable = CombNotChecked | Matched | Mismatched | Added | Updated | Moved | SampleMatched | Unchanged,
         CombHasChecksum = CombAvailable | Missing,
         CombUpdatable = New | Missing | Mismatched,
         CombDbChanged = Added | Removed | Updated | Imported | Moved,
-        CombChecked = Matched | Mismatched,
+        CombChecked = Matched | Mismatched | SampleMatched | Unchanged,
         CombMatched = Matched | Added | Updated | Moved,
         CombNewLost = New | Missing,
         CombUnreadable = UnPermitted | ReadError,
@@ -81,10 +84,35 @@ public:
     FileStatus status = FileStatus::NotSet;
     HashingPurpose hash_purpose = Generic;
 
+    // the algorithm of the computed checksum, 0 if not set (the digest length is not always enough)
+    QCryptographicHash::Algorithm hash_algo = static_cast<QCryptographicHash::Algorithm>(0);
+
     qint64 hash_time = -1;    // hashing time in milliseconds, -1 if not set
     qint64 size = -1;         // file size in bytes, -1 if not set
     QString checksum;         // newly computed or imported from the database
     QString reChecksum;       // the re-computed one (for verification purpose)
+
+    // the digests of the additional algorithms of a multi-digest database, computed in the same pass
+    QMap<QCryptographicHash::Algorithm, QString> extraChecksums;
+
+    // the digest of the file sample (Hasher::calculateSample): stored for the spot-checks of large files
+    QString sampleChecksum;
+
+    // the file state before hashing (storage::fingerprint), stored when the checksum is matched or added
+    QString fingerprint;
+
+    // the block digests of a large file as stored (BlockList::toString)
+    QString blockChecksums;
+
+    // the computed raw block digests of the main algorithm (Hasher::s_blockSize), joined:
+    // of the entire file when added, or of the verified blocks
+    QByteArray blockDigests;
+
+    // the hash state at the end of a large file (TailState::toString), of the computed checksum
+    QString tailState;
+
+    // verification by the blocks: the {offset, length} ranges of the file that differ from the stored ones
+    QList<QPair<qint64, qint64>> changedRanges;
 }; // struct FileValues
 
 using FileStatus = FileValues::FileStatus;
@@ -5,7 +5,26 @@
 */
 #include "hasher.h"
 #include "tools.h"
+#include "hashfunction.h"
+#include "readahead.h"
+#include "mapguard.h"
+#include "iopolicy.h"
+#include "uringreader.h"
+#include "chunktuner.h"
+#include "storage.h"
+#include "sha.h"
+#include "tailstate.h"
 #include <QFile>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 Hasher::Hasher(QObject *parent)
     : QObject(parent)
@@ -15,6 +34,11 @@ Hasher::Hasher(QCryptographicHash::Algorithm algo, QObject *parent)
     : QObject(parent), m_algo(algo)
 {}
 
+Hasher::~Hasher()
+{
+    delete m_uring;
+}
+
 void Hasher::setAlgorithm(QCryptographicHash::Algorithm algo)
 {
     m_algo = algo;
@@ -25,34 +49,712 @@ void Hasher::setProcState(const ProcState *procState)
     m_proc = procState;
 }
 
+void Hasher::setThreads(int threads)
+{
+    m_threads = qMax(1, threads);
+}
+
+void Hasher::setBufferPool(BufferPool *pool)
+{
+    m_buffers = pool ? pool : &m_ownBuffers;
+}
+
+void Hasher::setReadOptions(const ReadOptions &options)
+{
+    m_options = options;
+}
+
+int Hasher::chunkSize(QCryptographicHash::Algorithm algo, int threads)
+{
+    return (algo == Algo::Blake3 && threads > 1) ? s_chunkMultiThread : s_chunk;
+}
+
+int Hasher::buffersPerFile()
+{
+    return s_readAheadBuffers;
+}
+
 QString Hasher::calculate(const QString &filePath)
 {
     return calculate(filePath, m_algo);
 }
 
 QString Hasher::calculate(const QString &filePath, QCryptographicHash::Algorithm algo)
+{
+    return calculate(filePath, QList<QCryptographicHash::Algorithm>{ algo }).first();
+}
+
+QStringList Hasher::calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos)
+{
+    return calculate(filePath, algos, nullptr);
+}
+
+QStringList Hasher::calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos,
+                              QByteArray *blockDigests)
+{
+    return calculate(filePath, algos, blockDigests, nullptr);
+}
+
+QStringList Hasher::calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos,
+                              QByteArray *blockDigests, TailState *tail, QString *sample)
+{
+    QFile file(filePath);
+    iopolicy::openFile(file, m_options.cacheFriendly);
+
+    MultiHash hash(algos);
+    hash.setThreads(m_threads);
+
+    if (blockDigests)
+        hash.setBlockSize(s_blockSize);
+
+    // the sampled ranges are hashed apart as they are read, followed by the size (::calculateSample)
+    if (sample && hasSample(file.size()))
+        hash.setRanges(sampleRanges(file.size()), QByteArray::number(file.size()));
+
+    const bool isTreeMode = hash.contains(Algo::Blake3) && m_threads > 1;
+    int chunk = (m_options.chunk > 0) ? m_options.chunk
+                                      : chunkSize(isTreeMode ? Algo::Blake3 : algos.first(), m_threads);
+
+    // the adaptive read size; the tree mode needs its large blocks
+    ChunkTuner *tuner = (isTreeMode || m_options.chunk > 0) ? nullptr : m_options.tuner;
+    const quint64 device = tuner ? storage::deviceId(file.handle()) : 0;
+
+    if (tuner)
+        chunk = tuner->chunkSize(device);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 fileSize = file.size();
+
+    // the mapped memory is guarded in the calling thread only, so no BLAKE3 tree mode threads;
+    // unguarded, a file truncated while being read would crash the app instead of a read error
+    const bool mapped = m_options.mapped
+                        && mapguard::isAvailable()
+                        && file.size() >= s_mapMinSize
+                        && !isTreeMode;
+
+    // the explicitly enabled io_uring takes precedence over the mapping
+    const bool uring = m_options.queueDepth > 1 && file.size() > chunk;
+
+    // the holes of a sparse file are not read at all, whatever the reading method
+    const bool isSparseRead = hashSparse(file, hash, chunk);
+    const bool isUringRead = !isSparseRead && uring && hashUring(file, hash, chunk);
+    const bool isMappedRead = !isSparseRead && !isUringRead && mapped && hashMapped(file, hash, chunk);
+
+    if (!isSparseRead && !isUringRead && !isMappedRead) {
+        if (s_readAheadBuffers > 1 && file.size() > chunk)
+            hashReadAhead(file, hash, chunk);
+        else
+            hashSequential(file, hash, chunk);
+    }
+
+    if (isCanceled())
+        throw Exception(ERR_CANCELED);
+
+    // the small files are read at once, the mapped ones regardless of the read size, the sparse ones partly
+    if (tuner && !isMappedRead && !isSparseRead && file.size() > chunk)
+        tuner->addSample(device, chunk, file.size(), timer.nsecsElapsed());
+
+    // result
+    QStringList digests;
+
+    for (const QByteArray &res : hash.results())
+        digests << res.toHex();
+
+    if (blockDigests)
+        *blockDigests = hash.blockResults();
+
+    // none if the file has been shortened meanwhile
+    if (sample)
+        *sample = hash.rangesResult().toHex();
+
+    // the state is of the hashed size only if the file has not been resized meanwhile
+    if (tail) {
+        *tail = TailState();
+        const QByteArray state = hash.state();
+
+        if (!state.isEmpty() && hasTail(fileSize) && file.size() == fileSize)
+            *tail = TailState(fileSize, digests.first(), edgeDigest(file, algos.first(), fileSize), state);
+    }
+
+    return digests;
+}
+
+QString Hasher::calculateTail(const QString &filePath, QCryptographicHash::Algorithm algo,
+                              const TailState &previous, TailState *tail)
+{
+    QFile file(filePath);
+    iopolicy::openFile(file, m_options.cacheFriendly);
+
+    const qint64 fileSize = file.size();
+
+    if (!previous.isValid() || fileSize <= previous.fileSize()
+        || edgeDigest(file, algo, previous.fileSize()) != previous.edgeDigest())
+    {
+        return QString();
+    }
+
+    MultiHash hash({ algo });
+    hash.setThreads(m_threads);
+
+    // e.g. saved by the SHA instructions, which this CPU does not have
+    if (!hash.setState(previous.state()))
+        return QString();
+
+    if (!file.seek(previous.fileSize()))
+        throw Exception(ERR_READ, "File read error.");
+
+    hashSequential(file, hash, chunkSize(algo, m_threads));
+
+    if (isCanceled())
+        throw Exception(ERR_CANCELED);
+
+    const QString digest = hash.results().first().toHex();
+
+    if (tail) {
+        *tail = TailState();
+
+        if (file.size() == fileSize)
+            *tail = TailState(fileSize, digest, edgeDigest(file, algo, fileSize), hash.state());
+    }
+
+    return digest;
+}
+
+qint64 Hasher::readSmall(const QString &filePath, char *buffer)
+{
+#if defined(Q_OS_UNIX)
+    const QByteArray path = QFile::encodeName(filePath);
+    const int flags = O_RDONLY | O_CLOEXEC;
+
+#if defined(Q_OS_LINUX)
+    int fd = ::open(path.constData(), m_options.cacheFriendly ? (flags | O_NOATIME) : flags);
+
+    // O_NOATIME is only permitted to the file owner
+    if (fd < 0 && errno == EPERM && m_options.cacheFriendly)
+        fd = ::open(path.constData(), flags);
+#else
+    int fd = ::open(path.constData(), flags);
+#endif
+
+    if (fd < 0) {
+        switch (errno) {
+        case ENOENT:
+        case ENOTDIR:
+            throw Exception(ERR_NOTEXIST, "File not found.");
+        case EACCES:
+        case EPERM:
+            throw Exception(ERR_NOPERM, "No read permissions.");
+        default:
+            throw Exception(ERR_READ, "File open error.");
+        }
+    }
+
+    // one byte more than the limit: to find out whether the file has grown;
+    // a read may return less than requested before the end (network or FUSE file systems)
+    qint64 size = 0;
+
+    while (size <= s_smallFileSize) {
+        const ssize_t res = ::read(fd, buffer + size, s_smallFileSize + 1 - size);
+
+        if (res < 0 && errno == EINTR)
+            continue;
+
+        if (res <= 0) {
+            if (res < 0)
+                size = -1;
+            break;
+        }
+
+        size += res;
+    }
+
+#if defined(Q_OS_LINUX)
+    if (m_options.cacheFriendly && size > 0)
+        posix_fadvise(fd, 0, size, POSIX_FADV_DONTNEED);
+#endif
+
+    ::close(fd);
+
+    if (size < 0)
+        throw Exception(ERR_READ, "File read error.");
+
+    return size;
+#else
+    QFile file(filePath);
+    iopolicy::openFile(file, m_options.cacheFriendly);
+
+    qint64 size = 0;
+
+    while (size <= s_smallFileSize) {
+        const qint64 res = file.read(buffer + size, s_smallFileSize + 1 - size);
+
+        if (res < 0)
+            throw Exception(ERR_READ, "File read error.");
+
+        if (res == 0)
+            break;
+
+        size += res;
+    }
+
+    return size;
+#endif
+}
+
+QStringList Hasher::calculateSmall(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos)
+{
+#if defined(Q_OS_UNIX)
+    if (m_smallBuffer.size() <= s_smallFileSize)
+        m_smallBuffer.resize(s_smallFileSize + 1);
+
+    const qint64 size = readSmall(filePath, m_smallBuffer.data());
+
+    // the file has grown over the limit
+    if (size > s_smallFileSize)
+        return calculate(filePath, algos);
+
+    MultiHash hash(algos);
+    hash.addData(m_smallBuffer.constData(), size);
+    emit doneChunk(size);
+
+    QStringList digests;
+
+    for (const QByteArray &res : hash.results())
+        digests << res.toHex();
+
+    return digests;
+#else
+    return calculate(filePath, algos);
+#endif
+}
+
+QStringList Hasher::calculateSmallSha256(const QStringList &filePaths, QList<int> &errors)
+{
+    const int count = filePaths.size();
+    QStringList digests;
+    errors.clear();
+
+    // the contents of the files one after another, till all of them are read
+    QList<qint64> offsets;
+    QList<qint64> sizes;
+    QList<int> read;    // the indexes of the files to hash together
+    qint64 used = 0;
+
+    for (int i = 0; i < count; ++i) {
+        digests << QString();
+        errors << 0;
+        offsets << used;
+        sizes << 0;
+
+        if (isCanceled()) {
+            errors[i] = ERR_CANCELED;
+            continue;
+        }
+
+        if (m_multiBuffer.size() < used + s_smallFileSize + 1)
+            m_multiBuffer.resize(used + s_smallFileSize + 1);
+
+        try {
+            const qint64 size = readSmall(filePaths.at(i), m_multiBuffer.data() + used);
+
+            // the file has grown
+            if (size > s_smallFileSize) {
+                digests[i] = calculate(filePaths.at(i), QCryptographicHash::Sha256);
+                continue;
+            }
+
+            sizes[i] = size;
+            used += size;
+            read << i;
+        }
+        catch (const Exception &e) {
+            errors[i] = e.errorCode;
+        }
+    }
+
+    if (read.isEmpty())
+        return digests;
+
+    std::vector<const uint8_t*> data;
+    std::vector<size_t> lengths;
+    data.reserve(read.size());
+    lengths.reserve(read.size());
+
+    const uint8_t *base = reinterpret_cast<const uint8_t*>(m_multiBuffer.constData());
+
+    for (const int i : std::as_const(read)) {
+        data.push_back(base + offsets.at(i));
+        lengths.push_back(static_cast<size_t>(sizes.at(i)));
+    }
+
+    QByteArray raw(read.size() * 32, Qt::Uninitialized);
+    Sha::sha256Multi(data.data(), lengths.data(), data.size(), reinterpret_cast<uint8_t*>(raw.data()));
+    emit doneChunk(static_cast<int>(used));
+
+    for (int k = 0; k < read.size(); ++k)
+        digests[read.at(k)] = QString::fromLatin1(raw.mid(k * 32, 32).toHex());
+
+    return digests;
+}
+
+bool Hasher::isMultiBufferPreferred()
+{
+    // a single stream of the SHA instructions is faster than the SIMD lanes
+    return Sha::multiLanes() > 0 && !Sha::isSupported(Sha::Sha256);
+}
+
+QString Hasher::calculateSample(const QString &filePath, QCryptographicHash::Algorithm algo)
 {
     QFile file(filePath);
-    tools::openFile(file, QFile::ReadOnly);
+    iopolicy::openFile(file, m_options.cacheFriendly);
 
-    QCryptographicHash hash(algo);
+    const qint64 fileSize = file.size();
+
+    MultiHash hash({ algo });
+    hashRanges(file, hash, sampleRanges(fileSize), true);
+
+    // a file of another size never matches
+    const QByteArray strSize = QByteArray::number(fileSize);
+    hash.addData(strSize.constData(), strSize.size());
+
+    return hash.results().first().toHex();
+}
+
+QByteArray Hasher::calculateBlocks(const QString &filePath, QCryptographicHash::Algorithm algo, const QList<int> &blocks)
+{
+    QFile file(filePath);
+    iopolicy::openFile(file, m_options.cacheFriendly);
+
+    const qint64 fileSize = file.size();
+    const BufferPool::Buffer buf = m_buffers->acquire(s_chunk);
+
+    HashFunction hash(algo);
+    QByteArray digests;
+
+    for (const int block : blocks) {
+        const qint64 offset = block * s_blockSize;
+
+        if (offset >= fileSize)
+            break;
+
+        if (!file.seek(offset))
+            throw Exception(ERR_READ, "File read error.");
+
+        qint64 left = qMin(s_blockSize, fileSize - offset);
+
+        while (left > 0) {
+            if (isCanceled())
+                throw Exception(ERR_CANCELED);
+
+            const qint64 size = file.read(buf.data(), qMin<qint64>(left, buf.size()));
+
+            if (size <= 0)
+                throw Exception(ERR_READ, "File read error.");
+
+            hash.addData(buf.data(), size);
+            emit doneChunk(size);
+            left -= size;
+        }
+
+        releaseCache(file, offset, qMin(s_blockSize, fileSize - offset));
+        digests += hash.result();
+        hash.reset();
+    }
+
+    return digests;
+}
+
+void Hasher::hashRanges(QFile &file, MultiHash &hash, const QList<QPair<qint64, qint64>> &ranges, bool progress)
+{
+    const BufferPool::Buffer buf = m_buffers->acquire(s_chunk);
+
+    for (const QPair<qint64, qint64> &range : ranges) {
+        if (!file.seek(range.first))
+            throw Exception(ERR_READ, "File read error.");
+
+        qint64 left = range.second;
+
+        while (left > 0) {
+            if (isCanceled())
+                throw Exception(ERR_CANCELED);
+
+            const qint64 size = file.read(buf.data(), qMin<qint64>(left, buf.size()));
+
+            if (size <= 0)
+                throw Exception(ERR_READ, "File read error.");
+
+            hash.addData(buf.data(), size);
+            left -= size;
+
+            if (progress)
+                emit doneChunk(size);
+        }
+
+        releaseCache(file, range.first, range.second);
+    }
+}
+
+QString Hasher::edgeDigest(QFile &file, QCryptographicHash::Algorithm algo, qint64 length)
+{
+    const qint64 edge = qMin(s_tailEdge, length / 2);
+
+    MultiHash hash({ algo });
+    hashRanges(file, hash, { { 0, edge }, { length - edge, edge } }, false);
+
+    const QByteArray strSize = QByteArray::number(length);
+    hash.addData(strSize.constData(), strSize.size());
+
+    return hash.results().first().toHex();
+}
+
+bool Hasher::hasTail(qint64 fileSize)
+{
+    return fileSize >= s_tailMinSize;
+}
+
+bool Hasher::hasBlocks(qint64 fileSize)
+{
+    return fileSize >= s_blocksMinSize;
+}
+
+bool Hasher::hasSample(qint64 fileSize)
+{
+    return fileSize >= s_sampleMinSize;
+}
+
+qint64 Hasher::sampleSize(qint64 fileSize)
+{
+    qint64 size = 0;
+
+    for (const QPair<qint64, qint64> &range : sampleRanges(fileSize))
+        size += range.second;
+
+    return size;
+}
+
+QList<QPair<qint64, qint64>> Hasher::sampleRanges(qint64 fileSize)
+{
+    if (fileSize <= 2 * s_sampleEdge)
+        return { { 0, qMax<qint64>(0, fileSize) } };
+
+    // the blocks are aligned within the middle part, so they either coincide or don't overlap
+    const qint64 middle = fileSize - 2 * s_sampleEdge;
+    const quint64 slots = quint64(middle / s_sampleBlock);
+    QList<qint64> blocks;
+
+    for (int i = 0; slots > 0 && i < s_sampleBlocks; ++i) {
+        // splitmix64 of the size and the block number
+        quint64 x = quint64(fileSize) + quint64(i + 1) * 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x ^= (x >> 31);
+
+        const qint64 offset = s_sampleEdge + qint64(x % slots) * s_sampleBlock;
+        if (!blocks.contains(offset))
+            blocks << offset;
+    }
+
+    std::sort(blocks.begin(), blocks.end());
+
+    QList<QPair<qint64, qint64>> ranges = { { 0, s_sampleEdge } };
+
+    for (const qint64 offset : std::as_const(blocks))
+        ranges.append({ offset, s_sampleBlock });
+
+    ranges.append({ fileSize - s_sampleEdge, s_sampleEdge });
+
+    return ranges;
+}
+
+void Hasher::hashSequential(QFile &file, MultiHash &hash, int chunk)
+{
+    const BufferPool::Buffer buf = m_buffers->acquire(chunk);
+    qint64 offset = file.pos(); // the appended part of a grown file (::calculateTail)
+
+    // a file smaller than the chunk is read by a single exact-size read
+    const qint64 readSize = (file.size() > 0 && file.size() < chunk) ? file.size() : chunk;
 
     while (!file.atEnd() && !isCanceled()) {
-        const QByteArray &buf = file.read(m_chunk);
+        const qint64 size = file.read(buf.data(), readSize);
 
-        if (buf.size() > 0) {
-            hash.addData(buf);
-            emit doneChunk(buf.size());
+        if (size > 0) {
+            hash.addData(buf.data(), size);
+            releaseCache(file, offset, size);
+            offset += size;
+            emit doneChunk(size);
         } else {
             throw Exception(ERR_READ, "File read error.");
         }
     }
+}
 
-    if (isCanceled())
-        throw Exception(ERR_CANCELED);
+void Hasher::hashReadAhead(QFile &file, MultiHash &hash, int chunk)
+{
+    ReadAhead reader(&file, m_buffers, chunk, s_readAheadBuffers);
+    qint64 offset = 0;
 
-    // result
-    return hash.result().toHex();
+    while (!isCanceled()) {
+        const char *data = nullptr;
+        const qint64 size = reader.next(&data);
+
+        if (size == 0)
+            break;
+
+        if (size < 0)
+            throw Exception(ERR_READ, "File read error.");
+
+        hash.addData(data, size);
+        reader.release();
+        releaseCache(file, offset, size);
+        offset += size;
+        emit doneChunk(size);
+    }
+}
+
+bool Hasher::hashMapped(QFile &file, MultiHash &hash, int chunk)
+{
+    const qint64 fileSize = file.size();
+
+    for (qint64 offset = 0; offset < fileSize && !isCanceled(); offset += s_mapWindow) {
+        const qint64 windowSize = qMin(s_mapWindow, fileSize - offset);
+        uchar *window = file.map(offset, windowSize);
+
+        if (!window) {
+            // not mappable (e.g. special file system), the regular reading is used instead
+            if (offset == 0)
+                return false;
+
+            throw Exception(ERR_READ, "File read error.");
+        }
+
+        mapguard::adviseSequential(window, windowSize);
+
+        // passing by chunks to keep the progress and cancellation granularity
+        for (qint64 pos = 0; pos < windowSize && !isCanceled(); pos += chunk) {
+            const char *data = reinterpret_cast<const char *>(window + pos);
+            const qint64 size = qMin<qint64>(chunk, windowSize - pos);
+
+            // SIGBUS: the file was truncated or could not be read
+            if (!mapguard::call([&]{ hash.addData(data, size); })) {
+                file.unmap(window);
+                throw Exception(ERR_READ, "File read error.");
+            }
+
+            emit doneChunk(size);
+        }
+
+        file.unmap(window);
+        releaseCache(file, offset, windowSize);
+    }
+
+    return true;
+}
+
+bool Hasher::hashUring(QFile &file, MultiHash &hash, int chunk)
+{
+    UringReader *reader = uringReader(chunk);
+
+    if (!reader)
+        return false;
+
+    qint64 offset = 0;
+
+    auto consumer = [&](const char *data, qint64 size) {
+        if (isCanceled())
+            return false;
+
+        hash.addData(data, size);
+        releaseCache(file, offset, size);
+        offset += size;
+        emit doneChunk(size);
+
+        return true;
+    }; // lambda consumer
+
+    if (reader->readFile(file.handle(), file.size(), consumer) == UringReader::ReadError)
+        throw Exception(ERR_READ, "File read error.");
+
+    return true;
+}
+
+bool Hasher::hashSparse(QFile &file, MultiHash &hash, int chunk)
+{
+    const QList<QPair<qint64, qint64>> holes = storage::holes(file.handle(), s_holeMinSize);
+
+    if (holes.isEmpty())
+        return false;
+
+    // the digests are the same as of the full read: the hash takes the zeros the holes read as
+    static const QByteArray s_zeros(s_chunk, '\0');
+
+    const BufferPool::Buffer buf = m_buffers->acquire(chunk);
+    qint64 pos = 0;
+
+    auto hashData = [&](qint64 end) {
+        if (pos < end && !file.seek(pos))
+            throw Exception(ERR_READ, "File read error.");
+
+        while (pos < end && !isCanceled()) {
+            const qint64 size = file.read(buf.data(), qMin<qint64>(chunk, end - pos));
+
+            // the file has shrunk
+            if (size <= 0)
+                throw Exception(ERR_READ, "File read error.");
+
+            hash.addData(buf.data(), size);
+            releaseCache(file, pos, size);
+            pos += size;
+            emit doneChunk(size);
+        }
+    }; // lambda hashData
+
+    auto hashZeros = [&](qint64 end) {
+        while (pos < end && !isCanceled()) {
+            const qint64 size = qMin<qint64>(s_zeros.size(), end - pos);
+
+            hash.addData(s_zeros.constData(), size);
+            pos += size;
+            emit doneChunk(size);
+        }
+    }; // lambda hashZeros
+
+    for (const QPair<qint64, qint64> &hole : holes) {
+        hashData(hole.first);
+        hashZeros(hole.first + hole.second);
+    }
+
+    hashData(file.size());
+
+    return true;
+}
+
+UringReader* Hasher::uringReader(int chunk)
+{
+    if (m_uring && (m_uring->chunkSize() != chunk || m_uring->queueDepth() != m_options.queueDepth)) {
+        delete m_uring;
+        m_uring = nullptr;
+    }
+
+    if (!m_uring && !m_uringFailed) {
+        m_uring = new UringReader(m_buffers, m_options.queueDepth, chunk);
+
+        if (!m_uring->isValid()) {
+            qWarning() << "io_uring is not available, the regular reading is used";
+            delete m_uring;
+            m_uring = nullptr;
+            m_uringFailed = true;
+        }
+    }
+
+    return m_uring;
+}
+
+void Hasher::releaseCache(QFile &file, qint64 offset, qint64 size)
+{
+    if (m_options.cacheFriendly)
+        iopolicy::dropCache(file, offset, size);
 }
 
 bool Hasher::isCanceled() const
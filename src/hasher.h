@@ -7,27 +7,187 @@
 #define HASHER_H
 
 #include <QObject>
+#include <QStringList>
 #include "QCryptographicHash"
 #include "procstate.h"
+#include "bufferpool.h"
+
+class QFile;
+class MultiHash;
+class UringReader;
+class ChunkTuner;
+class TailState;
 
 class Hasher : public QObject
 {
     Q_OBJECT
 
 public:
+    // the file reading options, taken from the Settings
+    struct ReadOptions {
+        bool mapped = true;         // large files are hashed directly from the memory-mapped windows
+        bool cacheFriendly = false; // no atime updates, the hashed data is dropped from the page cache
+        int queueDepth = 0;         // > 1: io_uring reading with the number of reads in flight (Linux)
+        ChunkTuner *tuner = nullptr; // the read size is tuned per device; nullptr: the fixed size
+        int chunk = 0;              // > 0: the fixed read size instead of the default one (benchmarks)
+    }; // struct ReadOptions
+
     explicit Hasher(QObject *parent = nullptr);
     explicit Hasher(QCryptographicHash::Algorithm algo, QObject *parent = nullptr);
+    ~Hasher();
     void setAlgorithm(QCryptographicHash::Algorithm algo);
     void setProcState(const ProcState *procState);
 
+    // the number of threads a single file may be hashed with (BLAKE3 tree mode)
+    void setThreads(int threads);
+
+    // the read buffers are taken from the 'pool', nullptr --> the Hasher's own one
+    void setBufferPool(BufferPool *pool);
+
+    void setReadOptions(const ReadOptions &options);
+
+    // the read buffer size for the algorithm and number of threads
+    static int chunkSize(QCryptographicHash::Algorithm algo, int threads);
+
+    // the max number of read buffers used at once while hashing a file
+    static int buffersPerFile();
+
     QString calculate(const QString &filePath);
     QString calculate(const QString &filePath, QCryptographicHash::Algorithm algo);
 
+    // hashes the file with all the 'algos' in a single pass; returns the digests in the same order
+    QStringList calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos);
+
+    // ... and the 'blockDigests' (if not nullptr): the raw digests of the s_blockSize blocks of the first algorithm, joined
+    QStringList calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos,
+                          QByteArray *blockDigests);
+
+    // ... and the 'tail' (if not nullptr): the state of the first algorithm at the end of a large file (::hasTail);
+    // invalid if the algorithm is not resumable or the file has been changed meanwhile;
+    // ... and the 'sample' (if not nullptr): the sample digest of a large file (::calculateSample), of the same pass
+    QStringList calculate(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos,
+                          QByteArray *blockDigests, TailState *tail, QString *sample = nullptr);
+
+    // the digest of a grown file, the hashing resumed from the 'previous' state: only the appended part is read,
+    // and the edges of the previous contents (the head and the end) to confirm they are the same;
+    // empty if they are not, or the file has not grown; the 'tail' is set to the new state.
+    // The rest of the previous contents is not read: a change there is not detected (Settings::hashing_resume_grown)
+    QString calculateTail(const QString &filePath, QCryptographicHash::Algorithm algo,
+                          const TailState &previous, TailState *tail);
+
+    // the file is large enough to store its state at the end (TailState)
+    static bool hasTail(qint64 fileSize);
+
+    // the same for a file expected to be up to s_smallFileSize: read at once into the Hasher's buffer,
+    // without the QFile overhead; a file that has grown is passed to the ::calculate
+    QStringList calculateSmall(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos);
+
+    // the files up to this size are hashed by the ::calculateSmall, in batches
+    static const qint64 s_smallFileSize = 65536;
+
+    // the SHA-256 digests of several small files (a batch), read one by one and hashed at once
+    // by the SIMD lanes of the CPU (Sha::sha256Multi); 'errors': the code of each file, 0 if hashed
+    QStringList calculateSmallSha256(const QStringList &filePaths, QList<int> &errors);
+
+    // the CPU has the SIMD lanes for the ::calculateSmallSha256, and no SHA instructions that are faster
+    static bool isMultiBufferPreferred();
+
+    // spot-checks: the digest of the file sample, i.e. the head, the tail and the blocks between them
+    // at the offsets derived from the file size (the same ones each time); the size itself is hashed too
+    QString calculateSample(const QString &filePath, QCryptographicHash::Algorithm algo);
+
+    // the file is large enough to be checked by a sample; the smaller ones are verified in full
+    static bool hasSample(qint64 fileSize);
+
+    // the number of bytes read for the sample
+    static qint64 sampleSize(qint64 fileSize);
+
+    // the raw digests of the listed 'blocks' of the file (ascending), joined in the same order;
+    // the blocks beyond the end of the file (it has shrunk) are missing in the result
+    QByteArray calculateBlocks(const QString &filePath, QCryptographicHash::Algorithm algo, const QList<int> &blocks);
+
+    // the file is large enough to store its block digests
+    static bool hasBlocks(qint64 fileSize);
+
+    // the block-level digests: the size of a block
+    static const qint64 s_blockSize = 4194304;
+
 private:
+    // reads and hashes the file chunk by chunk in the current thread, from the current position
+    void hashSequential(QFile &file, MultiHash &hash, int chunk);
+
+    // the reading of the next chunks overlaps the hashing of the current one
+    void hashReadAhead(QFile &file, MultiHash &hash, int chunk);
+
+    // hashes the mapped windows of the file without copying; returns false if the file can't be mapped
+    bool hashMapped(QFile &file, MultiHash &hash, int chunk);
+
+    // several reads in flight via io_uring; returns false if io_uring is not available
+    bool hashUring(QFile &file, MultiHash &hash, int chunk);
+
+    // a sparse file: only its data ranges are read, the holes are hashed as zeros from memory;
+    // returns false if the file has no holes (of s_holeMinSize or more)
+    bool hashSparse(QFile &file, MultiHash &hash, int chunk);
+
+    // the io_uring reader for the current options, created on first use; nullptr if not available
+    UringReader* uringReader(int chunk);
+
+    // reads a small file (up to s_smallFileSize + 1 bytes) into the 'buffer', until its end or the limit; returns the size read
+    qint64 readSmall(const QString &filePath, char *buffer);
+
+    // hashes the {offset, length} 'ranges' of the file; 'progress': the doneChunk is emitted
+    void hashRanges(QFile &file, MultiHash &hash, const QList<QPair<qint64, qint64>> &ranges, bool progress);
+
+    // the hex digest of the head and the end of the file's first 'length' bytes, and the length;
+    // not counted in the progress
+    QString edgeDigest(QFile &file, QCryptographicHash::Algorithm algo, qint64 length);
+
+    // the hashed range of the file is no longer needed in the page cache (if cacheFriendly)
+    void releaseCache(QFile &file, qint64 offset, qint64 size);
+
     inline bool isCanceled() const;
 
+    // the sampled {offset, length} ranges of the file, ascending and not overlapping
+    static QList<QPair<qint64, qint64>> sampleRanges(qint64 fileSize);
+
     // file read buffer size
-    int m_chunk = 1048576;
+    static const int s_chunk = 1048576;
+
+    // ... when the file is hashed by several threads: the larger blocks are split into subtrees
+    static const int s_chunkMultiThread = 16777216;
+
+    // the number of read buffers in flight; files of more than one chunk are read ahead if > 1
+    static const int s_readAheadBuffers = 3;
+
+    // files from this size are memory-mapped (if enabled), by windows of the size
+    static const qint64 s_mapMinSize = 16777216;
+    static const qint64 s_mapWindow = 67108864;
+
+    // the smaller holes of a sparse file are read as usual
+    static const qint64 s_holeMinSize = 1048576;
+
+    // the sample: the head and tail of s_sampleEdge, s_sampleBlocks of s_sampleBlock between them
+    static const qint64 s_sampleMinSize = 16777216;
+    static const qint64 s_sampleEdge = 1048576;
+    static const qint64 s_sampleBlock = 65536;
+    static const int s_sampleBlocks = 8;
+
+    // the smaller files are checked in full only
+    static const qint64 s_blocksMinSize = 67108864;
+
+    // the state at the end is stored for the files from this size; the edges of the previous contents checked
+    static const qint64 s_tailMinSize = 67108864;
+    static const qint64 s_tailEdge = 1048576;
+
+    int m_threads = 1;
+    ReadOptions m_options;
+    QByteArray m_smallBuffer; // for the ::calculateSmall, allocated on first use
+    QByteArray m_multiBuffer; // ...::calculateSmallSha256, the files of a batch
+    BufferPool m_ownBuffers;
+    BufferPool *m_buffers = &m_ownBuffers;
+
+    UringReader *m_uring = nullptr;
+    bool m_uringFailed = false; // io_uring is not available, no more attempts
 
     QCryptographicHash::Algorithm m_algo = QCryptographicHash::Sha256;
     const ProcState *m_proc = nullptr;
@@ -0,0 +1,485 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "hasherpool.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include "tools.h"
+#include "storage.h"
+#include "iopolicy.h"
+#include "tailstate.h"
+
+HasherPool::HasherPool(const ProcState *procState,
+                       QCryptographicHash::Algorithm algo,
+                       FileValues::HashingPurpose purpose,
+                       int threads,
+                       BufferPool *bufferPool,
+                       const Hasher::ReadOptions &readOptions,
+                       Qos *qos)
+    : m_proc(procState), m_algo(algo), m_purpose(purpose), m_buffers(bufferPool), m_readOptions(readOptions), m_qos(qos)
+{
+    const int number = threadCount(threads);
+    m_workerCount = number;
+    m_hasherThreads = qMax(1, QThread::idealThreadCount() / number);
+
+    if (m_buffers)
+        m_buffers->reserve(Hasher::chunkSize(algo, m_hasherThreads), number * Hasher::buffersPerFile());
+
+    for (int i = 0; i < number; ++i) {
+        QThread *worker = QThread::create([this, i]{ run(i); });
+        worker->setObjectName(QStringLiteral(u"Hasher ") + QString::number(i + 1));
+        m_workers.append(worker);
+        worker->start();
+    }
+}
+
+HasherPool::~HasherPool()
+{
+    finish();
+}
+
+int HasherPool::threadCount(int preferred)
+{
+    return (preferred > 0) ? preferred : qMax(1, QThread::idealThreadCount());
+}
+
+bool HasherPool::isSmallFile(qint64 size)
+{
+    return (size >= 0 && size <= Hasher::s_smallFileSize);
+}
+
+int HasherPool::threads() const
+{
+    return m_workers.size();
+}
+
+void HasherPool::addJob(const Job &job)
+{
+    addBatch({ job });
+}
+
+void HasherPool::addBatch(const QList<Job> &jobs)
+{
+    if (jobs.isEmpty())
+        return;
+
+    const quint64 device = jobs.first().device;
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_devices.contains(device))
+        m_deviceOrder.append(device);
+
+    m_devices[device].jobs.enqueue(jobs);
+    m_pending += jobs.size();
+
+    // the woken worker could be the one over the QoS limit
+    if (m_qos && m_qos->threadLimit() > 0)
+        m_jobAdded.wakeAll();
+    else
+        m_jobAdded.wakeOne();
+}
+
+void HasherPool::setDeviceStreams(quint64 device, int streams)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_devices.contains(device))
+        m_deviceOrder.append(device);
+
+    m_devices[device].streams = qMax(0, streams);
+    m_jobAdded.wakeAll();
+}
+
+int HasherPool::pending() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending;
+}
+
+int HasherPool::pending(quint64 device) const
+{
+    QMutexLocker locker(&m_mutex);
+    const DeviceQueue dev = m_devices.value(device);
+    return dev.jobs.size() + dev.active;
+}
+
+bool HasherPool::takeResults(QList<Result> &results, int timeout)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_results.isEmpty() && m_pending > 0)
+        m_resultAdded.wait(&m_mutex, timeout);
+
+    if (m_results.isEmpty())
+        return false;
+
+    results.clear();
+    results.swap(m_results);
+    m_pending -= results.size();
+    return true;
+}
+
+qint64 HasherPool::takeDoneSize()
+{
+    return m_doneSize.exchange(0, std::memory_order_relaxed);
+}
+
+void HasherPool::finish()
+{
+    if (m_workers.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_finished = true;
+        m_devices.clear();
+        m_deviceOrder.clear();
+        m_jobAdded.wakeAll();
+    }
+
+    for (QThread *worker : std::as_const(m_workers)) {
+        worker->wait();
+        delete worker;
+    }
+
+    m_workers.clear();
+}
+
+void HasherPool::run(int number)
+{
+    Hasher hasher(m_algo);
+    hasher.setProcState(m_proc);
+    hasher.setThreads(m_hasherThreads);
+    hasher.setBufferPool(m_buffers);
+    hasher.setReadOptions(m_readOptions);
+
+    // no context object: the lambda is called directly in this worker thread
+    QObject::connect(&hasher, &Hasher::doneChunk,
+                     [this](int done) {
+                         m_doneSize.fetch_add(done, std::memory_order_relaxed);
+                         if (m_qos)
+                             m_qos->consume(done, m_proc);
+                     });
+
+    int qosGeneration = -1;
+
+    while (true) {
+        if (m_qos && m_qos->generation() != qosGeneration) {
+            qosGeneration = m_qos->generation();
+            applyQos(hasher);
+        }
+
+        QList<Job> unit;
+        QList<Job> nextJobs;
+
+        {
+            QMutexLocker locker(&m_mutex);
+            quint64 device = 0;
+
+            while (!m_finished && (!isAllowed(number) || !nextDevice(device))) {
+                // the QoS limit may be raised at any time, no signal for that
+                if (isAllowed(number))
+                    m_jobAdded.wait(&m_mutex);
+                else
+                    m_jobAdded.wait(&m_mutex, 250);
+            }
+
+            if (m_finished)
+                return;
+
+            DeviceQueue &dev = m_devices[device];
+            unit = dev.jobs.dequeue();
+            ++dev.active;
+
+            // each unit is prefetched once, by the worker that takes the one before
+            const int ahead = qMin(s_prefetchUnits, int(dev.jobs.size()));
+
+            for (int i = qMax(0, dev.prefetched - 1); i < ahead; ++i)
+                nextJobs.append(dev.jobs.at(i).first());
+
+            dev.prefetched = ahead;
+        }
+
+        for (const Job &job : std::as_const(nextJobs))
+            prefetch(job);
+
+        QList<Result> results;
+        results.reserve(unit.size());
+
+        if (isMultiBuffer(unit)) {
+            processMultiBuffer(hasher, unit, results);
+        } else {
+            for (int i = 0; i < unit.size(); ++i) {
+                const Job &job = unit.at(i);
+
+                if (i + 1 < unit.size())
+                    prefetch(unit.at(i + 1));
+
+                bool isLink = false;
+                const FileValues values = process(hasher, job, isLink);
+                results.append({ job.index, job.filePath, values, job.blocks, isLink });
+            }
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_results.append(results);
+        m_resultAdded.wakeOne();
+
+        QHash<quint64, DeviceQueue>::iterator it = m_devices.find(unit.first().device);
+        if (it != m_devices.end()) {
+            --it->active;
+
+            // the stream is free, the next file of the device can be taken by a waiting worker
+            if (it->streams > 0 && !it->jobs.isEmpty())
+                m_jobAdded.wakeOne();
+        }
+    }
+}
+
+FileValues HasherPool::process(Hasher &hasher, const Job &job, bool &isLink)
+{
+    FileValues values(m_purpose, job.size);
+
+    if (isCanceled())
+        return values;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QList<QCryptographicHash::Algorithm> algos = job.algos.isEmpty() ? QList<QCryptographicHash::Algorithm>{ m_algo }
+                                                                            : job.algos;
+
+    // a hard-linked file hashed by this job first: its values are passed to the other paths
+    QPair<quint64, quint64> link;
+    bool isFirstLink = false;
+
+    try {
+        values.hash_algo = algos.first();
+
+        if (job.sample == Job::SampleOnly) {
+            values.sampleChecksum = hasher.calculateSample(job.filePath, algos.first());
+            values.hash_time = timer.elapsed();
+            return values;
+        }
+
+        // the state of the file before hashing; if it was being modified meanwhile, there is no fingerprint
+        const QString fingerprint = storage::fingerprint(job.filePath, &link);
+
+        if (job.blockMode == Job::BlocksOnly) {
+            values.blockDigests = hasher.calculateBlocks(job.filePath, algos.first(), job.blocks);
+            values.hash_time = timer.elapsed();
+
+            if (fingerprint == storage::fingerprint(job.filePath))
+                values.fingerprint = fingerprint;
+            return values;
+        }
+
+        if (job.tail == Job::TailOnly) {
+            TailState tail;
+            const QString digest = hasher.calculateTail(job.filePath, algos.first(),
+                                                        TailState::fromString(job.tailState), &tail);
+            values.hash_time = timer.elapsed();
+
+            if (!digest.isEmpty()) {
+                if (fingerprint == storage::fingerprint(job.filePath))
+                    values.fingerprint = fingerprint;
+                values.defaultChecksum() = digest;
+                values.tailState = tail.toString();
+            }
+            return values;
+        }
+
+        // another path of a hard-linked file already hashed
+        if (link.second != 0 && takeLink(link, algos, fingerprint, values, isFirstLink)) {
+            m_doneSize.fetch_add(job.size, std::memory_order_relaxed);
+            isLink = true;
+            return values;
+        }
+
+        QByteArray *blockDigests = (job.blockMode == Job::AddBlocks) ? &values.blockDigests : nullptr;
+        QString *sample = (job.sample == Job::AddSample) ? &values.sampleChecksum : nullptr;
+        TailState tail;
+        TailState *pTail = (job.tail == Job::AddTail && algos.first() == m_algo) ? &tail : nullptr;
+
+        const QStringList digests = isSmallFile(job.size) ? hasher.calculateSmall(job.filePath, algos)
+                                            : hasher.calculate(job.filePath, algos, blockDigests, pTail, sample);
+        values.hash_time = timer.elapsed();
+        values.tailState = tail.toString();
+
+        if (fingerprint == storage::fingerprint(job.filePath))
+            values.fingerprint = fingerprint;
+        values.defaultChecksum() = digests.first();
+
+        for (int i = 1; i < digests.size(); ++i)
+            values.extraChecksums[algos.at(i)] = digests.at(i);
+    }
+    catch (const Exception &e) {
+        values.status = tools::failedCalcStatus(e.errorCode, m_purpose == FileValues::Verify);
+
+        if (e.errorCode == ERR_READ)
+            qWarning() << "Read ERROR:" << job.filePath;
+    }
+
+    if (isFirstLink)
+        finishLink(link, values);
+
+    return values;
+}
+
+bool HasherPool::takeLink(const QPair<quint64, quint64> &link, const QList<QCryptographicHash::Algorithm> &algos,
+                          const QString &fingerprint, FileValues &values, bool &isFirst)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<QPair<quint64, quint64>, Link>::const_iterator it = m_links.constFind(link);
+
+    if (it == m_links.constEnd()) {
+        m_links[link].algos = algos;
+        isFirst = true;
+        return false;
+    }
+
+    // the paths of a file are usually listed together, the first one may still be in progress
+    while (!it->isDone && !isCanceled()) {
+        m_linkDone.wait(&m_mutex, 100);
+        it = m_links.constFind(link); // the hash may have been changed meanwhile
+    }
+
+    // the first one has failed or the file has been modified since
+    if (!it->isDone
+        || it->algos != algos
+        || fingerprint.isEmpty()
+        || it->values.fingerprint != fingerprint)
+    {
+        return false;
+    }
+
+    values = it->values;
+    return true;
+}
+
+void HasherPool::finishLink(const QPair<quint64, quint64> &link, const FileValues &values)
+{
+    QMutexLocker locker(&m_mutex);
+    Link &first = m_links[link];
+    first.isDone = true;
+    first.values = values;
+    m_linkDone.wakeAll();
+}
+
+bool HasherPool::isMultiBuffer(const QList<Job> &unit) const
+{
+    if (unit.size() < 2 || !Hasher::isMultiBufferPreferred())
+        return false;
+
+    for (const Job &job : unit) {
+        const QCryptographicHash::Algorithm algo = job.algos.isEmpty() ? m_algo : job.algos.first();
+
+        if (!isSmallFile(job.size)
+            || job.sample != Job::NoSample
+            || job.blockMode != Job::NoBlocks
+            || job.algos.size() > 1
+            || algo != QCryptographicHash::Sha256)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HasherPool::processMultiBuffer(Hasher &hasher, const QList<Job> &unit, QList<Result> &results) const
+{
+    QStringList paths;
+    QStringList fingerprints;
+
+    for (const Job &job : unit) {
+        paths << job.filePath;
+        fingerprints << storage::fingerprint(job.filePath);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<int> errors;
+    const QStringList digests = hasher.calculateSmallSha256(paths, errors);
+
+    // the time of the batch is shared by its files
+    const qint64 time = timer.elapsed() / unit.size();
+
+    for (int i = 0; i < unit.size(); ++i) {
+        const Job &job = unit.at(i);
+        FileValues values(m_purpose, job.size);
+
+        // canceled: the values are not set, as of a job not taken (::process)
+        if (errors.at(i) != 0 && errors.at(i) != ERR_CANCELED) {
+            values.status = tools::failedCalcStatus(errors.at(i), m_purpose == FileValues::Verify);
+
+            if (errors.at(i) == ERR_READ)
+                qWarning() << "Read ERROR:" << job.filePath;
+        }
+        else if (errors.at(i) == 0) {
+            values.hash_algo = QCryptographicHash::Sha256;
+            values.hash_time = time;
+            values.defaultChecksum() = digests.at(i);
+
+            if (fingerprints.at(i) == storage::fingerprint(job.filePath))
+                values.fingerprint = fingerprints.at(i);
+        }
+
+        results.append({ job.index, job.filePath, values, job.blocks });
+    }
+}
+
+void HasherPool::prefetch(const Job &job) const
+{
+    // the sample and blocks are read at their own offsets
+    if (isCanceled() || job.sample == Job::SampleOnly || job.blockMode == Job::BlocksOnly)
+        return;
+
+    iopolicy::prefetch(job.filePath, qMin(job.size, s_prefetchSize));
+}
+
+bool HasherPool::nextDevice(quint64 &device)
+{
+    const int number = m_deviceOrder.size();
+
+    for (int i = 0; i < number; ++i) {
+        const int ind = (m_nextDevice + i) % number;
+        const DeviceQueue &dev = m_devices[m_deviceOrder.at(ind)];
+
+        if (!dev.jobs.isEmpty() && (dev.streams == 0 || dev.active < dev.streams)) {
+            device = m_deviceOrder.at(ind);
+            m_nextDevice = (ind + 1) % number;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool HasherPool::isAllowed(int number) const
+{
+    const int limit = m_qos ? m_qos->threadLimit() : 0;
+    return (limit <= 0 || number < limit);
+}
+
+void HasherPool::applyQos(Hasher &hasher)
+{
+    const Qos::Profile profile = m_qos->profile();
+    Qos::applyIoPriority(profile);
+
+    // the limit is shared by the allowed workers; a single one may hash a large file with all of them
+    int threads = m_hasherThreads;
+
+    if (profile.threads > 0)
+        threads = qMax(1, qMin(threads, profile.threads / qMin(profile.threads, m_workerCount)));
+
+    hasher.setThreads(threads);
+}
+
+bool HasherPool::isCanceled() const
+{
+    return (m_proc && m_proc->isCanceled());
+}
@@ -0,0 +1,197 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef HASHERPOOL_H
+#define HASHERPOOL_H
+
+#include <QCryptographicHash>
+#include <QModelIndex>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QHash>
+#include <QThread>
+#include <atomic>
+#include "procstate.h"
+#include "filevalues.h"
+#include "bufferpool.h"
+#include "hasher.h"
+#include "qos.h"
+
+/* A pool of worker threads, each with its own Hasher.
+ * The jobs are queued per device and taken in the order they were added, the devices in turn;
+ * a device may be limited to a number of files read at once (::setDeviceStreams), e.g. one for an HDD.
+ * A batch of small files (::addBatch) is a single work unit: hashed by one worker in a row,
+ * its results are passed at once.
+ * The results are collected by the owner (Manager) thread via ::takeResults,
+ * so the data model is never touched by the workers.
+ * The size of processed data is accumulated by the workers and should be passed
+ * to the ProcState by the owner thread (::takeDoneSize).
+ * The read buffers of all workers are taken from the 'bufferPool', which is sized for them on creation.
+ * The 'qos' limits (if any) are checked by the workers before each file: the workers over the thread limit wait,
+ * the I/O priority is set for each worker thread, and the reads are paced by the bandwidth cap.
+ * Taking a unit, the worker prefetches the files of the next ones of the device (the files of a batch in turn),
+ * so the open and the first reads of a file overlap the hashing of the previous one.
+ * A file with several hard links is hashed once: its other paths get the values of the first one (Result::isLink),
+ * if the file is in the same state (fingerprint). The links are found by the stat taken for the fingerprint.
+ */
+class HasherPool
+{
+public:
+    struct Job {
+        QModelIndex index;    // not used by the workers, returned with the result
+        QString filePath;
+        qint64 size = -1;
+        quint64 device = 0;   // the storage device the file resides on
+
+        // hashed in a single pass, the first one is the main; empty: the pool's algorithm
+        QList<QCryptographicHash::Algorithm> algos;
+
+        // the sample digest of a large file (spot-checks) is computed in the same pass as the full one,
+        // or instead of it; the result is FileValues::sampleChecksum
+        enum Sample : quint8 { NoSample, AddSample, SampleOnly };
+        Sample sample = NoSample;
+
+        // the block digests of the main algorithm (FileValues::blockDigests) are computed along with the full one,
+        // or only the digests of the 'blocks' instead of it (a part of the file verified by its blocks)
+        enum Blocks : quint8 { NoBlocks, AddBlocks, BlocksOnly };
+        Blocks blockMode = NoBlocks;
+        QList<int> blocks;
+
+        // the hash state at the end of a large file is saved along with the digest (FileValues::tailState),
+        // or a grown file is hashed from the stored 'tailState' on, if its previous contents are the same
+        // (no checksum otherwise); the main algorithm only
+        enum Tail : quint8 { NoTail, AddTail, TailOnly };
+        Tail tail = NoTail;
+        QString tailState;
+    }; // struct Job
+
+    struct Result {
+        QModelIndex index;
+        QString filePath;
+        FileValues values;
+        QList<int> blocks; // Job::BlocksOnly
+        bool isLink = false; // the values of another path of the same file (hard link), not read
+    }; // struct Result
+
+    HasherPool(const ProcState *procState,
+               QCryptographicHash::Algorithm algo,
+               FileValues::HashingPurpose purpose,
+               int threads = 0,
+               BufferPool *bufferPool = nullptr,
+               const Hasher::ReadOptions &readOptions = Hasher::ReadOptions(),
+               Qos *qos = nullptr);
+    ~HasherPool();
+
+    // 0 (auto) --> QThread::idealThreadCount()
+    static int threadCount(int preferred);
+
+    // the file is read at once (Hasher::calculateSmall) and may be batched
+    static bool isSmallFile(qint64 size);
+
+    // the max number of small files in a batch
+    static const int s_batchSize = 128;
+
+    // the work units of a device prefetched ahead of the one taken, and the length of a file prefetched
+    static const int s_prefetchUnits = 2;
+    static const qint64 s_prefetchSize = 4194304;
+
+    int threads() const;
+
+    void addJob(const Job &job);
+
+    // the 'jobs' of the same device (small files) are hashed by one worker and returned together
+    void addBatch(const QList<Job> &jobs);
+
+    // no more than 'streams' files of the 'device' are hashed at once; 0: no limit
+    void setDeviceStreams(quint64 device, int streams);
+
+    // the number of jobs added, whose results have not yet been taken
+    int pending() const;
+
+    // the number of work units (jobs or batches) of the 'device' that are queued or in progress
+    int pending(quint64 device) const;
+
+    // waits up to 'timeout' msecs for the results; takes all available, returns false if there are none
+    bool takeResults(QList<Result> &results, int timeout);
+
+    // returns the size of the data hashed since the previous call
+    qint64 takeDoneSize();
+
+    // drops the remaining jobs and waits for the workers to exit
+    void finish();
+
+private:
+    struct DeviceQueue {
+        QQueue<QList<Job>> jobs; // the work units
+        int active = 0;     // the units in progress
+        int streams = 0;    // the limit of the active jobs, 0: none
+        int prefetched = 0; // the units at the head of the queue whose files are prefetched
+    }; // struct DeviceQueue
+
+    // a file with several hard links (storage::fingerprint), hashed by the first of its paths taken
+    struct Link {
+        QList<QCryptographicHash::Algorithm> algos;
+        bool isDone = false;
+        FileValues values;
+    }; // struct Link
+
+    void run(int number); // worker thread loop, 'number' from 0
+    bool isCanceled() const;
+
+    // the worker is within the QoS thread limit
+    bool isAllowed(int number) const;
+
+    // the QoS profile has been changed: the I/O priority and threads per file of the worker
+    void applyQos(Hasher &hasher);
+
+    // hashes the job's file; 'isLink': the values are of another path of the file, it was not read
+    FileValues process(Hasher &hasher, const Job &job, bool &isLink);
+
+    // the values of the hard-linked file, if hashed by the 'algos' and in the same state ('fingerprint');
+    // waits for the one in progress. Returns false if there are none: the first path makes the caller
+    // the one to hash it, and to pass the values (::finishLink)
+    bool takeLink(const QPair<quint64, quint64> &link, const QList<QCryptographicHash::Algorithm> &algos,
+                  const QString &fingerprint, FileValues &values, bool &isFirst);
+    void finishLink(const QPair<quint64, quint64> &link, const FileValues &values);
+
+    // the small files of the batch are hashed at once by the SIMD lanes (Hasher::calculateSmallSha256)
+    bool isMultiBuffer(const QList<Job> &unit) const;
+    void processMultiBuffer(Hasher &hasher, const QList<Job> &unit, QList<Result> &results) const;
+
+    // the file of the job to be hashed soon is opened and its head is read in the background,
+    // so the device is kept busy across the file boundaries (iopolicy::prefetch)
+    void prefetch(const Job &job) const;
+
+    // the next device that has a job to take, in turn; returns false if there is none
+    bool nextDevice(quint64 &device);
+
+    const ProcState *m_proc = nullptr;
+    const QCryptographicHash::Algorithm m_algo;
+    const FileValues::HashingPurpose m_purpose;
+    int m_workerCount = 1;
+    int m_hasherThreads = 1; // the threads available to each worker for hashing a single file
+    BufferPool *m_buffers = nullptr;
+    const Hasher::ReadOptions m_readOptions;
+    Qos *m_qos = nullptr;
+
+    QList<QThread*> m_workers;
+    QHash<quint64, DeviceQueue> m_devices;
+    QList<quint64> m_deviceOrder; // in order of the first job added
+    int m_nextDevice = 0;
+    QList<Result> m_results;
+    int m_pending = 0;
+    bool m_finished = false;
+    QHash<QPair<quint64, quint64>, Link> m_links;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_jobAdded;
+    QWaitCondition m_resultAdded;
+    QWaitCondition m_linkDone;
+
+    std::atomic<qint64> m_doneSize { 0 };
+}; // class HasherPool
+
+#endif // HASHERPOOL_H
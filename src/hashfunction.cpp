@@ -0,0 +1,371 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "hashfunction.h"
+#include "blake3.h"
+#include "sha.h"
+#include "crc32c.h"
+
+// the SHA variant of the 'algo' that has the hardware kernel on this CPU
+static bool shaVariant(QCryptographicHash::Algorithm algo, Sha::Variant &variant)
+{
+    if (algo == QCryptographicHash::Sha1)
+        variant = Sha::Sha1;
+    else if (algo == QCryptographicHash::Sha256)
+        variant = Sha::Sha256;
+    else
+        return false;
+
+    return Sha::isSupported(variant);
+}
+
+HashFunction::HashFunction(QCryptographicHash::Algorithm algo)
+    : m_algo(algo)
+{
+    Sha::Variant variant;
+
+    if (algo == Algo::Blake3)
+        m_blake3 = new Blake3;
+    else if (algo == Algo::Crc32c)
+        m_crc32c = new Crc32c;
+    else if (shaVariant(algo, variant))
+        m_sha = new Sha(variant);
+    else
+        m_qtHash = new QCryptographicHash(algo);
+}
+
+HashFunction::~HashFunction()
+{
+    delete m_qtHash;
+    delete m_blake3;
+    delete m_sha;
+    delete m_crc32c;
+}
+
+QCryptographicHash::Algorithm HashFunction::algorithm() const
+{
+    return m_algo;
+}
+
+void HashFunction::setThreads(int threads)
+{
+    m_threads = qMax(1, threads);
+}
+
+int HashFunction::threads() const
+{
+    return m_threads;
+}
+
+void HashFunction::addData(const char *data, qsizetype length)
+{
+    if (m_blake3) {
+        m_blake3->update(data, static_cast<size_t>(length), m_threads);
+        return;
+    }
+
+    if (m_sha) {
+        m_sha->update(data, static_cast<size_t>(length));
+        return;
+    }
+
+    if (m_crc32c) {
+        m_crc32c->update(data, static_cast<size_t>(length));
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+    m_qtHash->addData(QByteArrayView(data, length));
+#else
+    m_qtHash->addData(data, static_cast<int>(length));
+#endif
+}
+
+void HashFunction::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+QByteArray HashFunction::result() const
+{
+    if (m_blake3) {
+        QByteArray res(Blake3::k_outLen, Qt::Uninitialized);
+        m_blake3->finalize(reinterpret_cast<uint8_t*>(res.data()));
+        return res;
+    }
+
+    if (m_sha) {
+        QByteArray res(static_cast<int>(m_sha->digestLength()), Qt::Uninitialized);
+        m_sha->finalize(reinterpret_cast<uint8_t*>(res.data()));
+        return res;
+    }
+
+    if (m_crc32c) {
+        QByteArray res(Crc32c::k_outLen, Qt::Uninitialized);
+        m_crc32c->finalize(reinterpret_cast<uint8_t*>(res.data()));
+        return res;
+    }
+
+    return m_qtHash->result();
+}
+
+void HashFunction::reset()
+{
+    if (m_blake3)
+        m_blake3->reset();
+    else if (m_sha)
+        m_sha->reset();
+    else if (m_crc32c)
+        m_crc32c->reset();
+    else
+        m_qtHash->reset();
+}
+
+// the algorithm (a byte), then the state of the implementation
+QByteArray HashFunction::state() const
+{
+    std::vector<uint8_t> raw;
+
+    if (m_blake3)
+        m_blake3->saveState(raw);
+    else if (m_sha)
+        m_sha->saveState(raw);
+    else if (m_crc32c)
+        m_crc32c->saveState(raw);
+    else
+        return QByteArray();
+
+    QByteArray res(1, static_cast<char>(m_algo));
+    res.append(reinterpret_cast<const char*>(raw.data()), static_cast<qsizetype>(raw.size()));
+    return res;
+}
+
+bool HashFunction::setState(const QByteArray &state)
+{
+    if (state.size() < 2 || static_cast<quint8>(state.at(0)) != m_algo)
+        return false;
+
+    const uint8_t *raw = reinterpret_cast<const uint8_t*>(state.constData()) + 1;
+    const size_t length = static_cast<size_t>(state.size() - 1);
+
+    if (m_blake3)
+        return m_blake3->loadState(raw, length);
+
+    if (m_sha)
+        return m_sha->loadState(raw, length);
+
+    if (m_crc32c)
+        return m_crc32c->loadState(raw, length);
+
+    return false;
+}
+
+bool HashFunction::isResumable(QCryptographicHash::Algorithm algo)
+{
+    Sha::Variant variant;
+    return algo == Algo::Blake3 || algo == Algo::Crc32c || shaVariant(algo, variant);
+}
+
+QCryptographicHash::Algorithm HashFunction::fastest(const QList<QCryptographicHash::Algorithm> &algos)
+{
+    // CRC32C is a few instructions per 8 bytes; BLAKE3 uses the SIMD kernels and all cores;
+    // SHA-512 is faster than SHA-256 on 64-bit CPUs
+    static const QList<QCryptographicHash::Algorithm> byThroughput = {
+        Algo::Crc32c,
+        Algo::Blake3,
+        QCryptographicHash::Md5,
+        QCryptographicHash::Sha1,
+        QCryptographicHash::Sha512,
+        QCryptographicHash::Sha256
+    };
+
+    // ...unless there are the SHA instructions
+    static const QList<QCryptographicHash::Algorithm> byThroughputShaHw = {
+        Algo::Crc32c,
+        Algo::Blake3,
+        QCryptographicHash::Sha1,
+        QCryptographicHash::Sha256,
+        QCryptographicHash::Md5,
+        QCryptographicHash::Sha512
+    };
+
+    const bool isShaHw = Sha::isSupported(Sha::Sha256);
+
+    for (const QCryptographicHash::Algorithm algo : (isShaHw ? byThroughputShaHw : byThroughput)) {
+        if (algos.contains(algo))
+            return algo;
+    }
+
+    return algos.isEmpty() ? static_cast<QCryptographicHash::Algorithm>(0) : algos.first();
+}
+
+QString HashFunction::engineName(QCryptographicHash::Algorithm algo)
+{
+    if (algo == Algo::Blake3)
+        return QStringLiteral(u"BLAKE3 ") + QLatin1String(Blake3::simdName());
+
+    if (algo == Algo::Crc32c)
+        return QLatin1String(Crc32c::engineName());
+
+    Sha::Variant variant;
+    if (shaVariant(algo, variant))
+        return QLatin1String(Sha::engineName());
+
+    return QStringLiteral(u"Qt");
+}
+
+MultiHash::MultiHash(const QList<QCryptographicHash::Algorithm> &algos)
+{
+    m_functions.reserve(algos.size());
+
+    for (const QCryptographicHash::Algorithm algo : algos)
+        m_functions.emplace_back(new HashFunction(algo));
+}
+
+QList<QCryptographicHash::Algorithm> MultiHash::algorithms() const
+{
+    QList<QCryptographicHash::Algorithm> algos;
+
+    for (const auto &func : m_functions)
+        algos << func->algorithm();
+
+    return algos;
+}
+
+bool MultiHash::contains(QCryptographicHash::Algorithm algo) const
+{
+    for (const auto &func : m_functions) {
+        if (func->algorithm() == algo)
+            return true;
+    }
+
+    return false;
+}
+
+void MultiHash::setThreads(int threads)
+{
+    for (const auto &func : m_functions)
+        func->setThreads(threads);
+}
+
+void MultiHash::addData(const char *data, qsizetype length)
+{
+    for (const auto &func : m_functions)
+        func->addData(data, length);
+
+    if (m_ranges)
+        addRangesData(data, length);
+
+    if (!m_block)
+        return;
+
+    while (length > 0) {
+        const qsizetype part = qsizetype(qMin<qint64>(length, m_blockSize - m_blockFilled));
+        m_block->addData(data, part);
+        m_blockFilled += part;
+        data += part;
+        length -= part;
+
+        if (m_blockFilled == m_blockSize) {
+            m_blockDigests += m_block->result();
+            m_block->reset();
+            m_blockFilled = 0;
+        }
+    }
+}
+
+QList<QByteArray> MultiHash::results() const
+{
+    QList<QByteArray> res;
+
+    for (const auto &func : m_functions)
+        res << func->result();
+
+    return res;
+}
+
+QByteArray MultiHash::state() const
+{
+    return m_functions.empty() ? QByteArray() : m_functions.front()->state();
+}
+
+bool MultiHash::setState(const QByteArray &state)
+{
+    return !m_functions.empty() && m_functions.front()->setState(state);
+}
+
+void MultiHash::setBlockSize(qint64 blockSize)
+{
+    if (blockSize <= 0 || m_functions.empty()) {
+        m_block.reset();
+        m_blockSize = 0;
+        return;
+    }
+
+    m_block.reset(new HashFunction(m_functions.front()->algorithm()));
+    m_blockSize = blockSize;
+    m_blockFilled = 0;
+    m_blockDigests.clear();
+}
+
+QByteArray MultiHash::blockResults() const
+{
+    if (!m_block)
+        return QByteArray();
+
+    return (m_blockFilled > 0) ? (m_blockDigests + m_block->result()) : m_blockDigests;
+}
+
+void MultiHash::setRanges(const QList<QPair<qint64, qint64>> &ranges, const QByteArray &suffix)
+{
+    if (ranges.isEmpty() || m_functions.empty()) {
+        m_ranges.reset();
+        m_rangeList.clear();
+        return;
+    }
+
+    m_ranges.reset(new HashFunction(m_functions.front()->algorithm()));
+    m_rangeList = ranges;
+    m_rangesSuffix = suffix;
+    m_nextRange = 0;
+    m_offset = 0;
+}
+
+QByteArray MultiHash::rangesResult() const
+{
+    if (!m_ranges || m_nextRange < m_rangeList.size())
+        return QByteArray();
+
+    return m_ranges->result();
+}
+
+void MultiHash::addRangesData(const char *data, qsizetype length)
+{
+    const qint64 end = m_offset + length;
+
+    while (m_nextRange < m_rangeList.size()) {
+        const QPair<qint64, qint64> &range = m_rangeList.at(m_nextRange);
+        const qint64 rangeEnd = range.first + range.second;
+
+        if (range.first >= end)
+            break;
+
+        // the part of the range within this data
+        const qint64 from = qMax(range.first, m_offset);
+        const qint64 to = qMin(rangeEnd, end);
+
+        if (to > from)
+            m_ranges->addData(data + (from - m_offset), to - from);
+
+        if (rangeEnd > end)
+            break;
+
+        // the last one is followed by the suffix
+        if (++m_nextRange == m_rangeList.size())
+            m_ranges->addData(m_rangesSuffix);
+    }
+
+    m_offset = end;
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef HASHFUNCTION_H
+#define HASHFUNCTION_H
+
+#include <QCryptographicHash>
+#include <QList>
+#include <QPair>
+#include <memory>
+#include <vector>
+#include "algostring.h"
+
+class Blake3;
+class Sha;
+class Crc32c;
+
+/* A common interface for the algorithms provided by QCryptographicHash
+ * and the ones implemented by the app (Algo::Blake3, Algo::Crc32c).
+ * SHA-1 and SHA-256 are computed by the hardware instructions of the CPU if there are any (class Sha),
+ * otherwise by QCryptographicHash.
+ */
+class HashFunction
+{
+public:
+    explicit HashFunction(QCryptographicHash::Algorithm algo);
+    ~HashFunction();
+
+    QCryptographicHash::Algorithm algorithm() const;
+
+    // the number of threads a single (large) data block may be hashed with, BLAKE3 only
+    void setThreads(int threads);
+    int threads() const;
+
+    void addData(const char *data, qsizetype length);
+    void addData(const QByteArray &data);
+    QByteArray result() const;
+    void reset();
+
+    // the intermediate state to continue the hashing from later (e.g. a grown file);
+    // empty if the algorithm is not ::isResumable
+    QByteArray state() const;
+
+    // returns false if the 'state' is not a saved one of this algorithm
+    bool setState(const QByteArray &state);
+
+    // the state of the algorithm can be saved: the ones implemented by the app, not by QCryptographicHash
+    static bool isResumable(QCryptographicHash::Algorithm algo);
+
+    // the algorithm expected to hash the data faster than the others on this machine
+    static QCryptographicHash::Algorithm fastest(const QList<QCryptographicHash::Algorithm> &algos);
+
+    // the implementation the 'algo' is computed with on this machine: "SHA-NI", "BLAKE3 AVX2", "SSE4.2", "Qt"...
+    static QString engineName(QCryptographicHash::Algorithm algo);
+
+private:
+    Q_DISABLE_COPY(HashFunction)
+
+    const QCryptographicHash::Algorithm m_algo;
+    QCryptographicHash *m_qtHash = nullptr;
+    Blake3 *m_blake3 = nullptr;
+    Sha *m_sha = nullptr;
+    Crc32c *m_crc32c = nullptr;
+    int m_threads = 1;
+}; // class HashFunction
+
+/* Several hash functions fed with the same data,
+ * so the file is read once for all the digests stored in the database.
+ */
+class MultiHash
+{
+public:
+    explicit MultiHash(const QList<QCryptographicHash::Algorithm> &algos);
+
+    QList<QCryptographicHash::Algorithm> algorithms() const;
+    bool contains(QCryptographicHash::Algorithm algo) const;
+
+    void setThreads(int threads);
+    void addData(const char *data, qsizetype length);
+
+    // the digests in the order of the algorithms
+    QList<QByteArray> results() const;
+
+    // the state of the first algorithm (HashFunction::state), and resuming from one
+    QByteArray state() const;
+    bool setState(const QByteArray &state);
+
+    // the consecutive blocks of the data are also hashed apart, by the first algorithm
+    void setBlockSize(qint64 blockSize);
+
+    // the raw digests of the blocks (the last one may be shorter), joined; empty if not set
+    QByteArray blockResults() const;
+
+    // the data at the {offset, length} 'ranges' of the stream (ascending, not overlapping) is also hashed apart,
+    // by the first algorithm, followed by the 'suffix'; e.g. the sample of a file, read along with the whole
+    void setRanges(const QList<QPair<qint64, qint64>> &ranges, const QByteArray &suffix = QByteArray());
+
+    // the raw digest of the ranges; empty if not set, or the data has ended before the last one
+    QByteArray rangesResult() const;
+
+private:
+    // the part of the 'data' within the ranges is passed to the m_ranges
+    void addRangesData(const char *data, qsizetype length);
+
+    std::vector<std::unique_ptr<HashFunction>> m_functions;
+
+    std::unique_ptr<HashFunction> m_block; // the current block
+    qint64 m_blockSize = 0;
+    qint64 m_blockFilled = 0;
+    QByteArray m_blockDigests;
+
+    std::unique_ptr<HashFunction> m_ranges;
+    QList<QPair<qint64, qint64>> m_rangeList;
+    QByteArray m_rangesSuffix;
+    int m_nextRange = 0; // the first one not yet done
+    qint64 m_offset = 0; // of the next data passed
+}; // class MultiHash
+
+#endif // HASHFUNCTION_H
@@ -66,6 +66,8 @@ QString IconProvider::svgFilePath(FileStatus status) const
         iconFileName = QStringLiteral(u"outdated");
         break;
     case FileStatus::Matched:
+    case FileStatus::SampleMatched:
+    case FileStatus::Unchanged:
         iconFileName = QStringLiteral(u"matched");
         break;
     case FileStatus::Mismatched:
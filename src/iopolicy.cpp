@@ -0,0 +1,99 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "iopolicy.h"
+#include "tools.h"
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#endif
+
+namespace iopolicy {
+
+#if defined(Q_OS_LINUX)
+static int openNoAtime(const QString &filePath)
+{
+    const QByteArray path = QFile::encodeName(filePath);
+    int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC | O_NOATIME);
+
+    // O_NOATIME is only permitted to the file owner (or CAP_FOWNER)
+    if (fd < 0 && errno == EPERM)
+        fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+
+    return fd;
+}
+#endif
+
+void openFile(QFile &file, bool cacheFriendly)
+{
+#if defined(Q_OS_LINUX)
+    if (cacheFriendly) {
+        const int fd = openNoAtime(file.fileName());
+
+        if (fd >= 0) {
+            if (file.open(fd, QFile::ReadOnly | QFile::Unbuffered, QFileDevice::AutoCloseHandle)) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+                return;
+            }
+
+            ::close(fd);
+        }
+        // the regular opening with its error handling
+    }
+#endif
+
+    // the reads go directly to the hasher's buffers, no copying through the QFile's own buffer
+    tools::openFile(file, QFile::ReadOnly | QFile::Unbuffered);
+
+#if defined(Q_OS_MACOS)
+    if (cacheFriendly)
+        fcntl(file.handle(), F_NOCACHE, 1);
+#endif
+}
+
+void dropCache(QFile &file, qint64 offset, qint64 length)
+{
+#if defined(Q_OS_LINUX)
+    if (length > 0)
+        posix_fadvise(file.handle(), offset, length, POSIX_FADV_DONTNEED);
+#else
+    Q_UNUSED(file)
+    Q_UNUSED(offset)
+    Q_UNUSED(length)
+#endif
+}
+
+void prefetch(const QString &filePath, qint64 length)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (length <= 0)
+        return;
+
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+
+    // the errors are reported by the hashing itself
+    if (fd < 0)
+        return;
+
+#if defined(Q_OS_LINUX)
+    posix_fadvise(fd, 0, length, POSIX_FADV_WILLNEED);
+#else
+    struct radvisory advice;
+    advice.ra_offset = 0;
+    advice.ra_count = static_cast<int>(qMin<qint64>(length, INT_MAX));
+    fcntl(fd, F_RDADVISE, &advice);
+#endif
+
+    ::close(fd);
+#else
+    Q_UNUSED(filePath)
+    Q_UNUSED(length)
+#endif
+}
+
+} // namespace iopolicy
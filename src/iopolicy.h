@@ -0,0 +1,31 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef IOPOLICY_H
+#define IOPOLICY_H
+
+#include <QFile>
+
+/* The page cache friendly file reading: a full verification reads every byte once,
+ * so the data should neither evict the working set of other processes from the page cache
+ * nor update the access time of every file.
+ * The hints are applied where the OS supports them, otherwise the functions do nothing.
+ */
+namespace iopolicy {
+
+// opens the file for reading (throws the same as tools::openFile); 'cacheFriendly':
+// Linux: O_NOATIME if permitted (the file owner), sequential access; macOS: F_NOCACHE
+void openFile(QFile &file, bool cacheFriendly);
+
+// drops the range already consumed from the page cache (POSIX_FADV_DONTNEED)
+void dropCache(QFile &file, qint64 offset, qint64 length);
+
+// the start of reading the first 'length' bytes of a file to be hashed next, in the background
+// (Linux: POSIX_FADV_WILLNEED, macOS: F_RDADVISE); the open and its latency are paid ahead too
+void prefetch(const QString &filePath, qint64 length);
+
+} // namespace iopolicy
+
+#endif // IOPOLICY_H
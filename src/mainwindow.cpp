@@ -35,6 +35,7 @@ MainWindow::MainWindow(QWidget *parent)
     ui->view->setSettings(m_settings);
 
     m_settings->loadSettings();
+    updateQos();
 
     restoreGeometry(m_settings->m_geometryMainWindow);
 
@@ -42,6 +43,7 @@ MainWindow::MainWindow(QWidget *parent)
     m_modeSelect->setManager(m_manager);
     m_modeSelect->setProcState(m_proc);
     ui->progressBar->setProcState(m_proc);
+    ui->progressBar->setQos(&m_manager->m_qos);
 
     m_modeSelect->m_menuAct->populateMenuFile(ui->menuFile);
     ui->menuHelp->addAction(m_modeSelect->m_menuAct->actionAbout);
@@ -158,6 +160,7 @@ void MainWindow::connectManager()
     connect(m_manager, &Manager::dbCreationDataCollected, this, &MainWindow::showDialogDbCreation);
     connect(m_manager, &Manager::dbContentsListCreated, this, &MainWindow::showDialogDbContents);
     connect(m_manager, &Manager::mismatchFound, this, &MainWindow::setWinTitleMismatchFound);
+    connect(m_manager, &Manager::hashingStats, this, [=](const QString &text){ m_hashingStats = text; });
 
     // results processing
     connect(m_manager, &Manager::setViewData, ui->view, &View::setData);
@@ -183,6 +186,7 @@ void MainWindow::connectManager()
     // <!> experimental
     connect(m_manager->m_proc, &ProcState::progressFinished, m_modeSelect, &ModeSelector::getInfoPathItem);
     connect(m_manager, &Manager::noAvailableItems, this, &MainWindow::dialogChooseWorkDir);
+    connect(m_manager, &Manager::checkpointFound, this, &MainWindow::promptResumeVerification);
 
     // change view
     connect(m_manager, &Manager::switchToFsPrepared, this, &MainWindow::switchToFs);
@@ -336,7 +340,7 @@ void MainWindow::showFolderCheckResult(const Numbers &result, const QString &sub
         const int n_mismatch = result.numberOf(FileStatus::Mismatched);
         messageText.append(QString("%1 out of %2 files %3 changed or corrupted.")
                             .arg(n_mismatch)
-                            .arg(result.numberOf(FileStatus::CombMatched | FileStatus::Mismatched)) // was before: FileStatus::CombAvailable
+                            .arg(result.numberOf(FileStatus::CombMatched | FileStatus::Mismatched | FileStatus::SampleMatched | FileStatus::Unchanged)) // was before: FileStatus::CombAvailable
                             .arg(n_mismatch == 1 ? "is" : "are"));
 
         const int n_notchecked = result.numberOf(FileStatus::CombNotChecked);
@@ -347,7 +351,23 @@ void MainWindow::showFolderCheckResult(const Numbers &result, const QString &sub
         }
     } else {
         messageText.append(QString("ALL %1 files passed verification.")
-                            .arg(result.numberOf(FileStatus::CombMatched)));
+                            .arg(result.numberOf(FileStatus::CombMatched | FileStatus::SampleMatched | FileStatus::Unchanged)));
+    }
+
+    // spot-check
+    const int n_sampled = result.numberOf(FileStatus::SampleMatched);
+    if (n_sampled) {
+        messageText.append("\n\n");
+        messageText.append(format::filesNumber(n_sampled)
+                           + QStringLiteral(u" matched by a sample only, not verified in full."));
+    }
+
+    // incremental check
+    const int n_unchanged = result.numberOf(FileStatus::Unchanged);
+    if (n_unchanged) {
+        messageText.append("\n\n");
+        messageText.append(format::filesNumber(n_unchanged)
+                           + QStringLiteral(u" unchanged since the last match, not read."));
     }
 
     FileStatus st_icon = result.contains(FileStatus::Mismatched) ? FileStatus::Mismatched
@@ -357,6 +377,11 @@ void MainWindow::showFolderCheckResult(const Numbers &result, const QString &sub
     msgBox.setWindowTitle(titleText);
     msgBox.setText(messageText);
 
+    if (!m_hashingStats.isEmpty()) {
+        msgBox.setDetailedText(m_hashingStats);
+        m_hashingStats.clear();
+    }
+
     const int ret = msgBox.exec();
 
     if (!m_modeSelect->isDbConst()
@@ -383,6 +408,7 @@ void MainWindow::dialogSettings()
         return;
 
     dialog.updateSettings();
+    updateQos();
 
     // switching "Detect Moved" cache
     if (ui->view->isViewDatabase()) {
@@ -460,6 +486,26 @@ void MainWindow::promptOpenBranch(const QString &dbFilePath)
     }
 }
 
+void MainWindow::promptResumeVerification(const QString &dbFilePath)
+{
+    QMessageBox msgBox(this);
+    msgBox.setIconPixmap(m_modeSelect->m_icons.pixmap(Icons::Database));
+    msgBox.setWindowTitle("Interrupted verification detected");
+    msgBox.setText("The verification of the database was interrupted:\n" + format::shortenPath(dbFilePath));
+    msgBox.setInformativeText("Do you want to resume it, skipping the files already verified?");
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::Discard | QMessageBox::Cancel);
+    msgBox.setDefaultButton(QMessageBox::Yes);
+    msgBox.button(QMessageBox::Yes)->setText("Resume");
+    msgBox.button(QMessageBox::Cancel)->setText("Later");
+
+    const int ret = msgBox.exec();
+
+    if (ret == QMessageBox::Yes)
+        m_manager->addTask(&Manager::resumeVerification);
+    else if (ret == QMessageBox::Discard)
+        Checkpoint::remove(dbFilePath);
+}
+
 void MainWindow::dialogSaveJson(VerJson *pUnsavedJson)
 {
     if (!pUnsavedJson) {
@@ -591,6 +637,17 @@ void MainWindow::updateStatusIcon()
     m_statusBar->setStatusIcon(statusIcon);
 }
 
+void MainWindow::updateQos()
+{
+    Qos::Profile profile;
+    profile.ioClass = static_cast<Qos::IoClass>(qBound(0, m_settings->qos_io_class, 2));
+    profile.ioLevel = m_settings->qos_io_level;
+    profile.bandwidth = m_settings->qos_bandwidth;
+    profile.threads = m_settings->qos_threads;
+
+    m_manager->m_qos.setProfile(profile);
+}
+
 void MainWindow::updatePermanentStatus()
 {
     if (ui->view->isViewDatabase()) {
@@ -54,6 +54,7 @@ public slots:
     void dialogChooseFolder();
     void dialogOpenJson();
     void promptOpenBranch(const QString &dbFilePath);
+    void promptResumeVerification(const QString &dbFilePath);
     void showFolderCheckResult(const Numbers &result,
                                const QString &subFolder);
     void showFileCheckResult(const QString &filePath,
@@ -91,6 +92,9 @@ private:
     // saves current settings to the file
     void saveSettings();
 
+    // passes the QoS profile from the settings to the Manager, applied to the running process as well
+    void updateQos();
+
     Ui::MainWindow *ui;
 
     // current app settings
@@ -105,6 +109,9 @@ private:
     StatusBar *m_statusBar = new StatusBar;
     ProcState *m_proc = nullptr;
 
+    // the details of the last hashing run, shown with the verification result
+    QString m_hashingStats;
+
     // true if the exit attempt was rejected (to perform data saving)
     // bool awaiting_closure = false;
 
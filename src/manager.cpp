@@ -11,6 +11,9 @@
 #include <QTimer>
 #include <QDebug>
 #include <QStringBuilder>
+#include <QRandomGenerator>
+#include <QDateTime>
+#include <algorithm>
 #include "files.h"
 #include "treemodeliterator.h"
 #include "tools.h"
@@ -18,6 +21,12 @@
 #include "backupfile.h"
 #include "algostring.h"
 #include "digeststring.h"
+#include "hasherpool.h"
+#include "hashfunction.h"
+#include "sha.h"
+#include "chunktuner.h"
+#include "storage.h"
+#include "tailstate.h"
 
 Manager::Manager(Settings *settings, QObject *parent)
     : QObject(parent), m_settings(settings)
@@ -25,6 +34,8 @@ Manager::Manager(Settings *settings, QObject *parent)
     m_files->setProcState(m_proc);
     m_dataMaintainer->setProcState(m_proc);
     m_shaCalc.setProcState(m_proc);
+    m_shaCalc.setThreads(QThread::idealThreadCount()); // a single file at a time
+    m_shaCalc.setBufferPool(&m_bufferPool);
 
     connect(&m_shaCalc, &Hasher::doneChunk, m_proc, &ProcState::addChunk);
     connect(m_dataMaintainer, &DataMaintainer::showMessage, this, &Manager::showMessage);
@@ -68,7 +79,7 @@ void Manager::sendDbUpdated()
     QTimer::singleShot(0, m_dataMaintainer, &DataMaintainer::databaseUpdated);
 }
 
-void Manager::processFolderSha(const MetaData &metaData)
+void Manager::processFolderSha(const MetaData &metaData, bool resume)
 {
     if (Files::isEmptyFolder(metaData.workDir, metaData.filter)) {
         emit showMessage("All files have been excluded.\n"
@@ -83,14 +94,30 @@ void Manager::processFolderSha(const MetaData &metaData)
 
     emit setViewData(m_dataMaintainer->m_data);
 
+    // the files already processed before the interruption
+    CalcModes mode = CM_Default;
+
+    if (resume) {
+        Checkpoint checkpoint;
+        if (checkpoint.load(metaData.dbFilePath)
+            && checkpoint.kind() == Checkpoint::Creation
+            && checkpoint.algorithm() == metaData.algorithm)
+        {
+            qDebug() << "Manager::processFolderSha | Resumed:" << applyCheckpoint(checkpoint);
+            mode = CM_Resume;
+        }
+    }
+
     // calculating checksums
-    calculateChecksums(FileStatus::Queued);
+    calculateChecksums(FileStatus::Queued, QModelIndex(), mode);
 
     // saving to json
     if (!m_proc->isCanceled()) {
         m_dataMaintainer->updateDateTime();
-        if (m_dataMaintainer->exportToJson()) // if saved successfully
+        if (m_dataMaintainer->exportToJson()) { // if saved successfully
+            Checkpoint::remove(metaData.dbFilePath);
             sendDbUpdated();
+        }
     }
 }
 
@@ -132,6 +159,17 @@ void Manager::createDataModel(const QString &dbFilePath, const QString &customWo
 
         emit setViewData(m_dataMaintainer->m_data);
 
+        // the previous verification was interrupted
+        Checkpoint::Kind cp_kind;
+        QCryptographicHash::Algorithm cp_algo;
+        if (m_settings->hashing_checkpoints
+            && Checkpoint::readInfo(dbFilePath, cp_kind, cp_algo)
+            && cp_kind == Checkpoint::Verification
+            && cp_algo == m_dataMaintainer->m_data->m_metadata.algorithm)
+        {
+            emit checkpointFound(dbFilePath);
+        }
+
         if (m_dataMaintainer->m_data->m_numbers.contains(FileStatus::CombAvailable))
             sendDbUpdated(); // using timer 0
         else
@@ -171,6 +209,27 @@ void Manager::updateDatabase(const DbMod dest)
     }
 
     if (dest == DM_UpdateMismatches) {
+        // the files found changed by their size were not read, their new checksums are computed first
+        int num_unhashed = 0;
+
+        for (TreeModelIterator iter(m_dataMaintainer->m_data->m_model); iter.hasNext();) {
+            if (iter.nextFile().status() == FileStatus::Mismatched && !TreeModel::hasReChecksum(iter.index())) {
+                m_dataMaintainer->setFileStatus(iter.index(), FileStatus::Queued);
+                ++num_unhashed;
+            }
+        }
+
+        if (num_unhashed > 0) {
+            m_dataMaintainer->updateNumbers();
+            calculateChecksums(DM_UpdateMismatches, FileStatus::Queued);
+
+            if (m_proc->isCanceled()) {
+                if (!m_proc->isState(State::Abort))
+                    m_dataMaintainer->changeStatuses(FileStatus::CombProcessing, FileStatus::Mismatched);
+                return;
+            }
+        }
+
         m_dataMaintainer->updateMismatchedChecksums();
     } else if (dest == DM_FindMoved) {
         calculateChecksums(DM_FindMoved, FileStatus::New);
@@ -230,12 +289,23 @@ void Manager::updateItemFile(const QModelIndex &fileIndex, DbMod job)
 
             m_dataMaintainer->importChecksum(fileIndex, dig);
         } else { // calc the new one
-            const FileValues fileVal = hashItem(fileIndex);
+            const FileValues fileVal = hashItem(fileIndex, Calculation, DataHelper::hasBlockDigests(pData),
+                                                DataHelper::hasSampleDigests(pData));
 
             if (fileVal.checksum.isEmpty()) { // return previous status
                 m_dataMaintainer->setFileStatus(fileIndex, prevStatus);
             } else {
                 m_dataMaintainer->updateChecksum(fileIndex, fileVal.checksum);
+                m_dataMaintainer->setExtraChecksums(fileIndex, fileVal.extraChecksums);
+                m_dataMaintainer->setFingerprint(fileIndex, fileVal.fingerprint);
+
+                if (!fileVal.blockDigests.isEmpty()) {
+                    const BlockList blocks(fileVal.size, Hasher::s_blockSize, fileVal.blockDigests,
+                                           AlgoString::digestLength(pData->m_metadata.algorithm) / 2);
+                    m_dataMaintainer->setBlockChecksums(fileIndex, blocks.toString());
+                }
+
+                m_dataMaintainer->setSampleChecksum(fileIndex, fileVal.sampleChecksum);
                 m_dataMaintainer->setItemValue(fileIndex, Column::ColumnElapsed, fileVal.hash_time);
                 m_dataMaintainer->setItemValue(fileIndex, Column::ColumnSpeed, fileVal.hash_speed());
             }
@@ -290,7 +360,9 @@ void Manager::verifyFileItem(const QModelIndex &fileItemIndex)
     const FileStatus storedStatus = TreeModel::itemFileStatus(fileItemIndex);
     const QString storedSum = TreeModel::itemFileChecksum(fileItemIndex);
 
-    if (!DigestString::isValid(storedSum) || !(storedStatus & FileStatus::CombAvailable)) {
+    if (!DigestString::isValid(storedSum, m_dataMaintainer->m_data->m_metadata.algorithm)
+        || !(storedStatus & FileStatus::CombAvailable))
+    {
         switch (storedStatus) {
         case FileStatus::Missing:
             emit showMessage("File does not exist", "Missing File");
@@ -311,16 +383,56 @@ void Manager::verifyFileItem(const QModelIndex &fileItemIndex)
         return;
     }
 
+    // a large file with the block digests: verified by several workers, only the changed blocks if known
+    const DataContainer *pData = m_dataMaintainer->m_data;
+    const QString filePath = DataHelper::itemAbsolutePath(pData, fileItemIndex);
+    const qint64 size = TreeModel::itemFileSize(fileItemIndex);
+    const BlockList blocks = BlockList::fromString(TreeModel::itemFileBlockChecksums(fileItemIndex),
+                                                   AlgoString::digestLength(pData->m_metadata.algorithm) / 2);
+
+    if (Hasher::hasBlocks(size)
+        && blocks.isValid()
+        && blocks.blockSize() == Hasher::s_blockSize
+        && blocks.fileSize() == size)
+    {
+        m_dataMaintainer->setFileStatus(fileItemIndex, FileStatus::Queued);
+        m_elapsedTimer.start();
+
+        calculateChecksums(FileStatus::Queued, fileItemIndex, CM_BlockCheck);
+
+        if (m_proc->isCanceled()) {
+            m_dataMaintainer->setFileStatus(fileItemIndex, storedStatus);
+            m_dataMaintainer->updateNumbers();
+            return;
+        }
+
+        FileValues fileVal(FileValues::Verify, size);
+        fileVal.status = TreeModel::itemFileStatus(fileItemIndex);
+        fileVal.hash_algo = pData->m_metadata.algorithm;
+        fileVal.hash_time = m_elapsedTimer.elapsed();
+        fileVal.checksum = storedSum.toLower();
+
+        fileVal.changedRanges = BlockList::ranges(TreeModel::itemFileChangedBlocks(fileItemIndex),
+                                                  blocks.fileSize(), blocks.blockSize());
+
+        emit fileProcessed(filePath, fileVal);
+        return;
+    }
+
     FileValues fileVal = hashItem(fileItemIndex, Verification);
 
     if (!fileVal.reChecksum.isEmpty()) {
-        m_dataMaintainer->updateChecksum(fileItemIndex, fileVal.reChecksum);
+        // the changed fingerprint is saved along with the next db changes
+        if (m_dataMaintainer->updateChecksum(fileItemIndex, fileVal.reChecksum, fileVal.hash_algo))
+            m_dataMaintainer->setFingerprint(fileItemIndex, fileVal.fingerprint);
+
         m_dataMaintainer->updateNumbers(fileItemIndex, storedStatus);
         m_dataMaintainer->setItemValue(fileItemIndex, Column::ColumnElapsed, fileVal.hash_time);
         m_dataMaintainer->setItemValue(fileItemIndex, Column::ColumnSpeed, fileVal.hash_speed());
 
-        fileVal.checksum = storedSum.toLower();
-        const QString filePath = DataHelper::itemAbsolutePath(m_dataMaintainer->m_data, fileItemIndex);
+        fileVal.checksum = (fileVal.hash_algo == pData->m_metadata.algorithm)
+                               ? storedSum.toLower()
+                               : TreeModel::itemFileExtraChecksum(fileItemIndex, fileVal.hash_algo);
         emit fileProcessed(filePath, fileVal);
     }
     else if (m_proc->isCanceled()) {
@@ -330,6 +442,11 @@ void Manager::verifyFileItem(const QModelIndex &fileItemIndex)
 }
 
 void Manager::verifyFolderItem(const QModelIndex &folderItemIndex, FileStatus checkstatus)
+{
+    verifyFolder(folderItemIndex, checkstatus, CM_Default);
+}
+
+void Manager::verifyFolder(const QModelIndex &folderItemIndex, FileStatus checkstatus, const CalcModes mode)
 {
     if (!m_dataMaintainer->m_data) {
         return;
@@ -344,12 +461,35 @@ void Manager::verifyFolderItem(const QModelIndex &folderItemIndex, FileStatus ch
         return;
     }
 
+    // the fast tier: a multi-digest db verified by the fastest stored digest (e.g. CRC32C),
+    // the entire one by the main algorithm on its cadence
+    const MetaData &meta = m_dataMaintainer->m_data->m_metadata;
+    const bool fast_tier = m_settings->verify_fastest_digest && !meta.extraAlgorithms.isEmpty();
+    const bool full_check = !fast_tier || (!folderItemIndex.isValid() && isFullCheckDue());
+
     // main job
-    calculateChecksums(checkstatus, folderItemIndex);
+    QList<QModelIndex> fast_mismatches;
+    calculateChecksums(checkstatus, folderItemIndex,
+                       (fast_tier && full_check) ? (mode | CM_FullCheck) : mode,
+                       &fast_mismatches);
 
     if (m_proc->isCanceled())
         return;
 
+    if (!full_check) {
+        recheckFastMismatches(fast_mismatches, folderItemIndex);
+
+        if (m_proc->isCanceled())
+            return;
+    }
+
+    // all the files of the db have been verified by the main algorithm
+    if (fast_tier && full_check && !folderItemIndex.isValid()
+        && FileStatuses(checkstatus).testFlag(FileStatus::CombAvailable))
+    {
+        m_dataMaintainer->updateFullCheckDateTime();
+    }
+
     // changing accompanying statuses to "Matched"
     // item statuses with checksums that can be considered already verified/matched
     FileStatuses accompStatuses = (FileStatus::Added | FileStatus::Updated | FileStatus::Moved);
@@ -373,6 +513,255 @@ void Manager::verifyFolderItem(const QModelIndex &folderItemIndex, FileStatus ch
     }
 }
 
+bool Manager::isFullCheckDue() const
+{
+    const QString &last = m_dataMaintainer->m_data->m_metadata.fullCheck;
+    const int days = m_settings->verify_full_days;
+
+    return days > 0 && (last.isEmpty() || tools::isLater(last, QDateTime::currentDateTime().addDays(-days)));
+}
+
+int Manager::recheckFastMismatches(const QList<QModelIndex> &mismatches, const QModelIndex &root)
+{
+    for (const QModelIndex &index : mismatches)
+        m_dataMaintainer->setFileStatus(index, FileStatus::Queued);
+
+    if (mismatches.isEmpty())
+        return 0;
+
+    m_dataMaintainer->updateNumbers();
+    qDebug() << "Manager::recheckFastMismatches |" << mismatches.size();
+
+    calculateChecksums(FileStatus::Queued, root, CM_FullCheck);
+
+    return mismatches.size();
+}
+
+void Manager::spotCheckFolderItem(const QModelIndex &folderItemIndex)
+{
+    DataContainer *pData = m_dataMaintainer->m_data;
+
+    if (!pData)
+        return;
+
+    if (!DataHelper::contains(pData, FileStatus::CombAvailable, folderItemIndex)) {
+        emit showMessage("There are no files available for verification.", "Warning");
+        return;
+    }
+
+    // the random subset of the available files, with their statuses to restore if not verified
+    const int percent = qBound(1, m_settings->spot_check_percent, 100);
+    QHash<QModelIndex, FileStatus> selected;
+
+    for (TreeModelIterator iter(pData->m_model, folderItemIndex); iter.hasNext();) {
+        if (iter.nextFile().hasStatus(FileStatus::CombAvailable)
+            && (percent == 100 || int(QRandomGenerator::global()->bounded(100)) < percent))
+        {
+            selected.insert(iter.index(), iter.status());
+            m_dataMaintainer->setFileStatus(iter.index(), FileStatus::Queued);
+        }
+    }
+
+    m_dataMaintainer->updateNumbers();
+    qDebug() << "Manager::spotCheckFolderItem | Selected:" << selected.size() << percent << '%';
+
+    // main job
+    calculateChecksums(FileStatus::Queued, folderItemIndex, CM_SpotCheck);
+
+    // the ones not verified (stopped, or no sample digest) keep their previous results: Added, Mismatched etc.
+    for (auto it = selected.constBegin(); it != selected.constEnd(); ++it) {
+        const FileStatus cur_status = TreeModel::itemFileStatus(it.key());
+
+        if ((cur_status & FileStatus::CombProcessing) || cur_status == FileStatus::NotChecked)
+            m_dataMaintainer->setFileStatus(it.key(), it.value());
+    }
+
+    m_dataMaintainer->updateNumbers();
+
+    if (m_proc->isCanceled())
+        return;
+
+    // result
+    if (!folderItemIndex.isValid()) {
+        emit folderChecked(pData->m_numbers);
+    } else {
+        emit folderChecked(DataHelper::getNumbers(pData, folderItemIndex), TreeModel::itemName(folderItemIndex));
+    }
+}
+
+void Manager::verifyChangedItems(const QModelIndex &folderItemIndex)
+{
+    const DataContainer *pData = m_dataMaintainer->m_data;
+
+    if (!pData)
+        return;
+
+    emit setStatusbarText(QStringLiteral(u"Checking the file states..."));
+    int number = 0;
+
+    for (TreeModelIterator iter(pData->m_model, folderItemIndex); iter.hasNext() && !m_proc->isCanceled();) {
+        if (!iter.nextFile().hasStatus(FileStatus::CombAvailable))
+            continue;
+
+        const QString stored = TreeModel::itemFileFingerprint(iter.index());
+
+        if (!stored.isEmpty() && stored == storage::fingerprint(DataHelper::itemAbsolutePath(pData, iter.index()))) {
+            m_dataMaintainer->setFileStatus(iter.index(), FileStatus::Unchanged);
+            ++number;
+        }
+    }
+
+    m_dataMaintainer->updateNumbers();
+    qDebug() << "Manager::verifyChangedItems | Unchanged:" << number;
+
+    if (m_proc->isCanceled())
+        return;
+
+    // the rest of the available ones
+    verifyFolderItem(folderItemIndex,
+                     static_cast<FileStatus>(FileStatus::CombAvailable & ~FileStatus::Unchanged));
+}
+
+void Manager::resumeVerification()
+{
+    const DataContainer *pData = m_dataMaintainer->m_data;
+
+    if (!pData)
+        return;
+
+    const QString &dbFilePath = pData->m_metadata.dbFilePath;
+    Checkpoint checkpoint;
+
+    if (!checkpoint.load(dbFilePath)
+        || checkpoint.kind() != Checkpoint::Verification
+        || checkpoint.algorithm() != pData->m_metadata.algorithm)
+    {
+        qDebug() << "Manager::resumeVerification | No proper checkpoint";
+        return;
+    }
+
+    qDebug() << "Manager::resumeVerification | Resumed:" << applyCheckpoint(checkpoint);
+
+    if (pData->m_numbers.contains(FileStatus::Mismatched))
+        emit mismatchFound();
+
+    // the rest of the items
+    verifyFolder(QModelIndex(), FileStatus::CombNotChecked, CM_Resume);
+
+    // nothing was left to verify, so the checkpoint was not reopened
+    if (!m_proc->isCanceled())
+        Checkpoint::remove(dbFilePath);
+}
+
+int Manager::applyCheckpoint(const Checkpoint &checkpoint)
+{
+    const DataContainer *pData = m_dataMaintainer->m_data;
+    const QHash<QString, Checkpoint::Item> &items = checkpoint.items();
+
+    if (!pData || items.isEmpty())
+        return 0;
+
+    const bool is_creation = (checkpoint.kind() == Checkpoint::Creation);
+    const FileStatuses not_processed = is_creation ? FileStatuses(FileStatus::Queued)
+                                                   : FileStatuses(FileStatus::CombNotChecked);
+    int applied = 0;
+    bool values_changed = false; // of the db being verified
+
+    for (TreeModelIterator iter(pData->m_model); iter.hasNext() && applied < items.size();) {
+        if (!iter.nextFile().hasStatus(not_processed))
+            continue;
+
+        const auto found = items.constFind(iter.path());
+        if (found == items.constEnd())
+            continue;
+
+        const Checkpoint::Item &item = found.value();
+        const QModelIndex &index = iter.index();
+
+        if (item.status & FileStatus::CombCalcError) {
+            m_dataMaintainer->setFileStatus(index, item.status);
+        }
+        else if (is_creation) {
+            if (item.status != FileStatus::Added || item.checksum.isEmpty())
+                continue;
+
+            m_dataMaintainer->setItemValue(index, Column::ColumnChecksum, item.checksum);
+            m_dataMaintainer->setExtraChecksums(index, item.extraChecksums);
+            m_dataMaintainer->setSampleChecksum(index, item.sampleChecksum);
+            m_dataMaintainer->setBlockChecksums(index, item.blockChecksums);
+            m_dataMaintainer->setTailState(index, item.tailState);
+            m_dataMaintainer->setFingerprint(index, item.fingerprint);
+            m_dataMaintainer->setFileStatus(index, FileStatus::Added);
+        }
+        else if (item.status & FileStatus::CombChecked) {
+            if (!item.checksum.isEmpty())
+                m_dataMaintainer->setItemValue(index, Column::ColumnReChecksum, item.checksum);
+
+            // the states the stored checksum was confirmed for
+            if (item.status == FileStatus::Matched) {
+                const bool is_tail_set = m_dataMaintainer->setTailState(index, item.tailState);
+                if (m_dataMaintainer->setFingerprint(index, item.fingerprint) || is_tail_set)
+                    values_changed = true;
+            }
+
+            if (item.status == FileStatus::Mismatched)
+                m_dataMaintainer->setChangedBlocks(index, item.changedBlocks);
+
+            m_dataMaintainer->setFileStatus(index, item.status);
+        }
+        else {
+            continue;
+        }
+
+        ++applied;
+    }
+
+    if (values_changed && !DataHelper::isImmutable(pData))
+        m_dataMaintainer->setDbFileState(DbFileState::NotSaved);
+
+    m_dataMaintainer->updateNumbers();
+    return applied;
+}
+
+Checkpoint::Item Manager::checkpointItem(const QModelIndex &fileIndex, bool isCreation)
+{
+    Checkpoint::Item item;
+    item.status = TreeModel::itemFileStatus(fileIndex);
+
+    if (item.status & FileStatus::CombCalcError)
+        return item;
+
+    if (isCreation) {
+        item.checksum = TreeModel::itemFileChecksum(fileIndex);
+        item.extraChecksums = TreeModel::itemFileExtraChecksums(fileIndex);
+        item.sampleChecksum = TreeModel::itemFileSampleChecksum(fileIndex);
+        item.blockChecksums = TreeModel::itemFileBlockChecksums(fileIndex);
+        item.tailState = TreeModel::itemFileTailState(fileIndex);
+        item.fingerprint = TreeModel::itemFileFingerprint(fileIndex);
+    }
+    else if (item.status == FileStatus::Matched) {
+        item.tailState = TreeModel::itemFileTailState(fileIndex);
+        item.fingerprint = TreeModel::itemFileFingerprint(fileIndex);
+    }
+    else if (item.status == FileStatus::Mismatched) {
+        // the recomputed checksum is stored only for the main algorithm (ReChecksum column)
+        item.checksum = TreeModel::itemFileReChecksum(fileIndex);
+        item.changedBlocks = TreeModel::itemFileChangedBlocks(fileIndex);
+    }
+
+    return item;
+}
+
+void Manager::addCheckedToCheckpoint()
+{
+    const DataContainer *pData = m_dataMaintainer->m_data;
+
+    for (TreeModelIterator iter(pData->m_model); iter.hasNext();) {
+        if (iter.nextFile().hasStatus(FileStatus::CombChecked))
+            m_checkpoint.add(iter.path(), checkpointItem(iter.index(), false));
+    }
+}
+
 void Manager::checkSummaryFile(const QString &path)
 {
     const QString storedChecksum = extractDigestFromFile(path);
@@ -397,7 +786,13 @@ void Manager::checkSummaryFile(const QString &path)
         }
     }
 
-    checkFile(checkFilePath, storedChecksum);
+    // the digest file extension points to the algorithm, if not, it is chosen by the digest length
+    const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(pathstr::suffix(path));
+
+    if (DigestString::isValid(storedChecksum, algo))
+        checkFile(checkFilePath, storedChecksum, algo);
+    else
+        checkFile(checkFilePath, storedChecksum);
 }
 
 QString Manager::extractDigestFromFile(const QString &digestFile, bool showException)
@@ -431,9 +826,16 @@ void Manager::checkFile(const QString &filePath, const QString &checkSum, QCrypt
 }
 
 FileValues Manager::hashFile(const QString &filePath, QCryptographicHash::Algorithm algo, const CalcKind calckind)
+{
+    return hashFile(filePath, QList<QCryptographicHash::Algorithm>{ algo }, calckind);
+}
+
+FileValues Manager::hashFile(const QString &filePath, const QList<QCryptographicHash::Algorithm> &algos,
+                             const CalcKind calckind, bool addBlocks, bool addSample)
 {
     QFileInfo fi(filePath);
     FileValues fileVal(fi.size());
+    fileVal.hash_algo = algos.first();
 
     if (calckind == Verification)
         fileVal.hash_purpose = FileValues::HashingPurpose::Verify;
@@ -445,27 +847,29 @@ FileValues Manager::hashFile(const QString &filePath, QCryptographicHash::Algori
 
     // hashing
     try {
+        m_shaCalc.setReadOptions(readOptions());
         m_elapsedTimer.start();
 
-        // automatic choose: '.checksum' or '.reChecksum'
-        fileVal.defaultChecksum() = m_shaCalc.calculate(filePath, algo);
+        const QString fingerprint = storage::fingerprint(filePath);
+        QByteArray *blockDigests = (addBlocks && Hasher::hasBlocks(fileVal.size)) ? &fileVal.blockDigests : nullptr;
+        QString *sample = addSample ? &fileVal.sampleChecksum : nullptr;
+        const QStringList digests = m_shaCalc.calculate(filePath, algos, blockDigests, nullptr, sample);
         fileVal.hash_time = m_elapsedTimer.elapsed();
+
+        if (fingerprint == storage::fingerprint(filePath))
+            fileVal.fingerprint = fingerprint;
+
+        // automatic choose: '.checksum' or '.reChecksum'
+        fileVal.defaultChecksum() = digests.first();
+
+        for (int i = 1; i < digests.size(); ++i)
+            fileVal.extraChecksums[algos.at(i)] = digests.at(i);
     }
     catch (const Exception& e) {
-        switch (e.errorCode) {
-        case ERR_READ:
-            fileVal.status = FileStatus::ReadError;
+        fileVal.status = tools::failedCalcStatus(e.errorCode, calckind == Verification);
+
+        if (e.errorCode == ERR_READ)
             qWarning() << "Read ERROR:" << filePath;
-            break;
-        case ERR_NOPERM:
-            fileVal.status = FileStatus::UnPermitted;
-            break;
-        case ERR_NOTEXIST:
-            fileVal.status = (calckind == Verification) ? FileStatus::Missing : FileStatus::Removed;
-            break;
-        default:
-            break;
-        }
 
         if (e.errorCode != ERR_CANCELED)
             emit setStatusbarText(e.what());
@@ -474,13 +878,13 @@ FileValues Manager::hashFile(const QString &filePath, QCryptographicHash::Algori
     return fileVal;
 }
 
-FileValues Manager::hashItem(const QModelIndex &ind, const CalcKind calckind)
+FileValues Manager::hashItem(const QModelIndex &ind, const CalcKind calckind, bool addBlocks, bool addSample)
 {
     m_dataMaintainer->setFileStatus(ind,
                                     calckind ? FileStatus::Verifying : FileStatus::Calculating);
 
     const QString filePath = DataHelper::itemAbsolutePath(m_dataMaintainer->m_data, ind);
-    const FileValues fileVal = hashFile(filePath, m_dataMaintainer->m_data->m_metadata.algorithm, calckind);
+    const FileValues fileVal = hashFile(filePath, itemAlgorithms(ind, calckind), calckind, addBlocks, addSample);
 
     // error handling
     if (fileVal.status & FileStatus::CombCalcError) {
@@ -490,6 +894,51 @@ FileValues Manager::hashItem(const QModelIndex &ind, const CalcKind calckind)
     return fileVal;
 }
 
+bool Manager::importDigestFile(const QModelIndex &fileIndex)
+{
+    const DataContainer *pData = m_dataMaintainer->m_data;
+    const QString filePath = DataHelper::itemAbsolutePath(pData, fileIndex);
+    const QString shaFilePath = paths::digestFilePath(filePath, pData->m_metadata.algorithm);
+
+    if (!QFileInfo::exists(shaFilePath))
+        return false;
+
+    const QString digest = extractDigestFromFile(shaFilePath, false);
+
+    return m_dataMaintainer->importChecksum(fileIndex, digest);
+}
+
+QList<QCryptographicHash::Algorithm> Manager::itemAlgorithms(const QModelIndex &fileIndex, const CalcKind calckind) const
+{
+    const MetaData &meta = m_dataMaintainer->m_data->m_metadata;
+    QList<QCryptographicHash::Algorithm> algos = { meta.algorithm };
+
+    if (meta.extraAlgorithms.isEmpty())
+        return algos;
+
+    if (calckind == Calculation)
+        return algos << meta.extraAlgorithms;
+
+    if (!m_settings->verify_fastest_digest)
+        return algos;
+
+    // the stored digests of this file
+    const QMap<QCryptographicHash::Algorithm, QString> extra = TreeModel::itemFileExtraChecksums(fileIndex);
+    algos << extra.keys();
+
+    return { HashFunction::fastest(algos) };
+}
+
+Hasher::ReadOptions Manager::readOptions() const
+{
+    Hasher::ReadOptions options;
+    options.mapped = m_settings->hashing_mmap;
+    options.cacheFriendly = m_settings->hashing_cache_friendly;
+    options.queueDepth = m_settings->hashing_queue_depth;
+
+    return options;
+}
+
 void Manager::updateProgText(const CalcKind calckind, const QString &file)
 {
     const QString purp = calckind ? QStringLiteral(u"Verifying") : QStringLiteral(u"Calculating");
@@ -524,12 +973,14 @@ void Manager::updateProgText(const CalcKind calckind, const QString &file)
     emit setStatusbarText(res);
 }
 
-int Manager::calculateChecksums(const FileStatus status, const QModelIndex &root)
+int Manager::calculateChecksums(const FileStatus status, const QModelIndex &root,
+                                const CalcModes mode, QList<QModelIndex> *fastMismatches)
 {
-    return calculateChecksums(DM_AutoSelect, status, root);
+    return calculateChecksums(DM_AutoSelect, status, root, mode, fastMismatches);
 }
 
-int Manager::calculateChecksums(const DbMod purpose, const FileStatus status, const QModelIndex &root)
+int Manager::calculateChecksums(const DbMod purpose, const FileStatus status, const QModelIndex &root,
+                                const CalcModes mode, QList<QModelIndex> *fastMismatches)
 {
     const DataContainer *pData = m_dataMaintainer->m_data;
 
@@ -552,66 +1003,251 @@ int Manager::calculateChecksums(const DbMod purpose, const FileStatus status, co
 
     m_proc->setTotal(num_queued);
 
-    bool isMismatchFound = false;
+    CalcRun run;
+    run.purpose = purpose;
+    run.status = status;
+    run.mode = mode;
 
     // checking whether this is a Calculation or Verification process
-    const CalcKind calc_kind = (status & FileStatus::CombAvailable) ? Verification : Calculation;
-    const bool allow_import = m_settings->m_importSumsWhenItemAdding && calc_kind == Calculation;
+    const bool is_check = mode.testFlag(CM_SpotCheck) || mode.testFlag(CM_BlockCheck) || mode.testFlag(CM_FullCheck);
+    run.kind = (is_check || (status & FileStatus::CombAvailable)) ? Verification : Calculation;
+
+    // not for the changed items re-hashed: a digest file next to them may be outdated
+    const bool allow_import = m_settings->m_importSumsWhenItemAdding && run.kind == Calculation
+                              && purpose != DM_UpdateMismatches;
+
+    // the new items are added to the db; the other digests of the changed ones are cleared by the update
+    const bool is_adding = run.kind == Calculation && purpose != DM_FindMoved && purpose != DM_UpdateMismatches;
 
     // process
-    TreeModelIterator iter(pData->m_model, root);
+    const FileValues::HashingPurpose hash_purp = (run.kind == Verification) ? FileValues::Verify
+                                                                            : FileValues::AddToDb;
+    const int threads = qMin(HasherPool::threadCount(m_settings->hashing_threads), num_queued.number);
+
+    // the read size is tuned per device during this run
+    ChunkTuner tuner(Hasher::chunkSize(pData->m_metadata.algorithm, 1));
+    tuner.setBufferPool(&m_bufferPool, threads * Hasher::buffersPerFile());
+
+    Hasher::ReadOptions read_options = readOptions();
+    if (m_settings->hashing_adaptive_chunk)
+        read_options.tuner = &tuner;
+
+    HasherPool pool(m_proc,
+                    pData->m_metadata.algorithm,
+                    hash_purp,
+                    threads,
+                    &m_bufferPool,
+                    read_options,
+                    &m_qos);
+
+    // the results are saved periodically to continue from after a crash;
+    // the creation and the verification of the entire db only
+    run.isCreation = DataHelper::isInCreation(pData);
+    if (m_settings->hashing_checkpoints
+        && purpose != DM_FindMoved
+        && !mode.testFlag(CM_SpotCheck)
+        && (run.isCreation || (run.kind == Verification && !root.isValid())))
+    {
+        m_checkpoint.open(pData->m_metadata.dbFilePath,
+                          run.isCreation ? Checkpoint::Creation : Checkpoint::Verification,
+                          pData->m_metadata.algorithm,
+                          mode.testFlag(CM_Resume));
+
+        // the resumed one has them in the file already
+        if (!run.isCreation && !mode.testFlag(CM_Resume))
+            addCheckedToCheckpoint();
+    }
 
-    while (iter.hasNext() && !m_proc->isCanceled()) {
+    // multi-digest db: the extra algorithms are hashed in the same pass as the main one
+    const bool has_extra_digests = !pData->m_metadata.extraAlgorithms.isEmpty();
+    run.countAlgos = run.kind == Verification && has_extra_digests;
+
+    // the sample and block digests of the large files are computed for the new items;
+    // when verifying, they are checked instead of the full checksums
+    run.addSamples = DataHelper::hasSampleDigests(pData) && is_adding;
+    run.addBlocks = DataHelper::hasBlockDigests(pData) && is_adding;
+    run.blockDigestLen = AlgoString::digestLength(pData->m_metadata.algorithm) / 2;
+
+    // the hash states at the end of the large files: saved along with their checksums,
+    // a grown file is updated by hashing the appended part (its stored state is of the stored checksum);
+    // opt-in, the previous contents are checked by their edges only
+    run.addTails = m_settings->hashing_resume_grown
+                   && purpose != DM_FindMoved && !mode.testFlag(CM_SpotCheck)
+                   && HashFunction::isResumable(pData->m_metadata.algorithm);
+
+    // the queued files by storage device, each in the tree order
+    QHash<quint64, QQueue<HasherPool::Job>> dev_jobs;
+    QHash<quint64, int> dev_max_pending;
+    QList<quint64> devices; // in order of the first file
+    QHash<QString, quint64> folder_devices; // {folder path : device}, a single stat() per folder
+    QList<quint64> rotational;
+    const bool detect_devices = m_settings->hashing_per_device || m_settings->hashing_layout_order;
+
+    for (TreeModelIterator iter(pData->m_model, root); iter.hasNext();) {
         if (iter.nextFile().status() != FileStatus::Queued)
             continue;
 
-        if (allow_import) {
-            const QString filePath = DataHelper::itemAbsolutePath(pData, iter.index());
-            const QString shaFilePath = paths::digestFilePath(filePath, pData->m_metadata.algorithm);
+        HasherPool::Job job = { iter.index(), DataHelper::itemAbsolutePath(pData, iter.index()), iter.size() };
 
-            if (QFileInfo::exists(shaFilePath)) {
-                const QString digest = extractDigestFromFile(shaFilePath, false);
+        if (!planJob(run, job))
+            continue;
+
+        if (detect_devices) {
+            const QString folder = pathstr::parentFolder(job.filePath);
+            QHash<QString, quint64>::const_iterator it = folder_devices.constFind(folder);
+
+            if (it == folder_devices.constEnd())
+                it = folder_devices.insert(folder, storage::deviceId(folder));
+
+            job.device = it.value();
+        }
+
+        if (!dev_jobs.contains(job.device)) {
+            devices.append(job.device);
+
+            if (detect_devices && storage::isRotational(job.device))
+                rotational.append(job.device);
 
-                if (m_dataMaintainer->importChecksum(iter.index(), digest)) {
+            // keeping a few jobs per worker of each device in advance, the rest of the items remain Queued;
+            // the ones prefetched by the pool are queued on top of that
+            const int streams = m_settings->hashing_per_device ? storage::preferredStreams(job.device) : 0;
+            dev_max_pending[job.device] = ((streams > 0) ? qMin(streams, pool.threads()) : pool.threads()) * 2
+                                          + HasherPool::s_prefetchUnits;
+
+            if (streams > 0) {
+                pool.setDeviceStreams(job.device, streams);
+                run.stats << QStringLiteral(u"Disk ") + storage::deviceName(job.device)
+                                 + QStringLiteral(u": rotational, one file at a time");
+            }
+        }
+
+        if (job.blockMode == HasherPool::Job::BlocksOnly) {
+            const QList<HasherPool::Job> parts = blockJobs(job);
+            run.blockChecks[job.index].parts = parts.size();
+
+            for (const HasherPool::Job &part : parts)
+                dev_jobs[job.device].enqueue(part);
+        } else {
+            dev_jobs[job.device].enqueue(job);
+        }
+    }
+
+    // fewer seeks on the spinning disks
+    if (m_settings->hashing_layout_order) {
+        for (const quint64 device : std::as_const(rotational))
+            sortByLayout(dev_jobs[device]);
+    }
+
+    // the devices are fed in turn, so a slow disk does not hold up the others
+    while (!m_proc->isCanceled()) {
+        // feeding the pool
+        for (const quint64 device : std::as_const(devices)) {
+            QQueue<HasherPool::Job> &jobs = dev_jobs[device];
+            const int max_pending = dev_max_pending.value(device);
+
+            QList<HasherPool::Job> batch; // the small files in a row
+
+            while (!jobs.isEmpty()
+                   && pool.pending(device) < max_pending
+                   && !m_proc->isCanceled())
+            {
+                HasherPool::Job job = jobs.dequeue();
+
+                if (allow_import && importDigestFile(job.index)) {
                     m_proc->addDoneOne();
                     continue;
                 }
+
+                // the sample and block digests are of the main algorithm
+                if (has_extra_digests
+                    && (run.kind == Calculation || !mode.testFlag(CM_FullCheck))
+                    && purpose != DM_FindMoved
+                    && job.sample != HasherPool::Job::SampleOnly
+                    && job.blockMode != HasherPool::Job::BlocksOnly
+                    && job.tail != HasherPool::Job::TailOnly)
+                {
+                    job.algos = itemAlgorithms(job.index, run.kind);
+                }
+
+                // the batched items remain Queued until their results are committed
+                if (HasherPool::isSmallFile(job.size)) {
+                    batch.append(job);
+
+                    if (batch.size() == HasherPool::s_batchSize) {
+                        pool.addBatch(batch);
+                        batch.clear();
+                    }
+                    continue;
+                }
+
+                // keeping the order of files
+                pool.addBatch(batch);
+                batch.clear();
+
+                m_dataMaintainer->setFileStatus(job.index,
+                                                run.kind ? FileStatus::Verifying : FileStatus::Calculating);
+
+                if (job.blockMode == HasherPool::Job::BlocksOnly) {
+                    QElapsedTimer &timer = run.blockChecks[job.index].timer;
+                    if (!timer.isValid())
+                        timer.start();
+                }
+
+                pool.addJob(job);
             }
-        }
 
-        // hashing
-        const FileValues fileVal = hashItem(iter.index(), calc_kind);
-        const QString &sum = fileVal.defaultChecksum();
+            pool.addBatch(batch);
+        }
 
-        if (m_proc->isCanceled())
+        if (!pool.pending())
             break;
 
-        if (sum.isEmpty()) {
-            m_proc->decreaseTotalQueued();
-            m_proc->decreaseTotalSize(iter.size());
-            continue;
-        }
+        QList<HasherPool::Result> results;
+        const bool hasResults = pool.takeResults(results, 100);
 
-        // success
-        m_proc->addDoneOne();
-        m_dataMaintainer->setItemValue(iter.index(), Column::ColumnElapsed, fileVal.hash_time);
-        m_dataMaintainer->setItemValue(iter.index(), Column::ColumnSpeed, fileVal.hash_speed());
+        m_proc->addChunk(pool.takeDoneSize());
 
-        if (purpose == DM_FindMoved) {
-            if (!m_dataMaintainer->tryMoved(iter.index(), sum))
-                m_dataMaintainer->setFileStatus(iter.index(), status); // rollback status
+        if (!hasResults || m_proc->isCanceled())
             continue;
-        }
 
-        // != DM_FindMoved
-        if (!m_dataMaintainer->updateChecksum(iter.index(), sum)
-            && !isMismatchFound) // the signal is only needed once
-        {
-            emit mismatchFound();
-            isMismatchFound = true;
-        }
+        // once per batch
+        updateProgText(run.kind, results.last().filePath);
+
+        for (const HasherPool::Result &res : std::as_const(results))
+            applyResult(run, pool, res);
+
+        if (m_checkpoint.isDue())
+            m_checkpoint.flush();
     }
 
+    pool.finish();
+
+    // the completed creation is kept until the db file is saved
+    m_checkpoint.close(!m_proc->isCanceled() && !run.isCreation);
+
+    qDebug() << "Manager::calculateChecksums | Read buffers: hits" << m_bufferPool.hits()
+             << "misses" << m_bufferPool.misses();
+
+    // the pool was sized for the workers, releasing the memory
+    m_bufferPool.clear();
+
+    if (read_options.tuner)
+        run.stats << tuner.summary();
+
+    addRunStats(run);
+
+    if (!run.stats.isEmpty())
+        qDebug() << "Manager::calculateChecksums |" << run.stats;
+
+    emit hashingStats(run.stats.join('\n'));
+
+    // the new fingerprints of the verified files; an immutable db keeps the ones of its creation
+    if (run.fingerprintsChanged && run.kind == Verification && !DataHelper::isImmutable(pData))
+        m_dataMaintainer->setDbFileState(DbFileState::NotSaved);
+
+    if (fastMismatches)
+        *fastMismatches = run.fastMismatches;
+
     const int done = m_proc->chunksQueue().done;
     if (m_proc->isCanceled()) {
         if (m_proc->isState(State::Abort)) {
@@ -629,6 +1265,417 @@ int Manager::calculateChecksums(const DbMod purpose, const FileStatus status, co
     return done;
 }
 
+bool Manager::planJob(CalcRun &run, HasherPool::Job &job)
+{
+    const bool spot_check = run.mode.testFlag(CM_SpotCheck);
+
+    if (run.kind == Verification) {
+        // the files whose size differs from the one at the last match are not read
+        const qint64 matched_size = storage::fingerprintSize(TreeModel::itemFileFingerprint(job.index));
+
+        if (matched_size >= 0 && matched_size != job.size) {
+            setSizeChanged(run, job);
+            return false;
+        }
+
+        if (!spot_check && Hasher::hasBlocks(job.size) && !planBlockCheck(run, job))
+            return false;
+    }
+
+    if (run.addTails && Hasher::hasTail(job.size) && job.blockMode != HasherPool::Job::BlocksOnly) {
+        const QString stored_tail = TreeModel::itemFileTailState(job.index);
+        const TailState tail = TailState::fromString(stored_tail);
+
+        // updating a grown file
+        if (run.kind == Calculation
+            && tail.isValid()
+            && job.size > tail.fileSize()
+            && tail.digest() == TreeModel::itemFileChecksum(job.index))
+        {
+            job.tail = HasherPool::Job::TailOnly;
+            job.tailState = stored_tail;
+            m_proc->decreaseTotalSize(tail.fileSize());
+            run.tailJobs.insert(job.index, job);
+        } else {
+            job.tail = HasherPool::Job::AddTail;
+        }
+    }
+
+    if (spot_check && Hasher::hasSample(job.size)) {
+        if (TreeModel::itemFileSampleChecksum(job.index).isEmpty()) {
+            // the full hashing of a large file is not a spot-check, it's left for the verification;
+            // its previous status is restored by the ::spotCheckFolderItem
+            m_dataMaintainer->setFileStatus(job.index, FileStatus::NotChecked);
+            m_proc->decreaseTotalQueued();
+            m_proc->decreaseTotalSize(job.size);
+            ++run.numNoSample;
+            return false;
+        }
+
+        job.sample = HasherPool::Job::SampleOnly;
+        m_proc->decreaseTotalSize(job.size - Hasher::sampleSize(job.size));
+        ++run.numSampled;
+    }
+    else if (run.addSamples && Hasher::hasSample(job.size) && job.tail != HasherPool::Job::TailOnly) {
+        job.sample = HasherPool::Job::AddSample;
+    }
+
+    if (run.addBlocks && Hasher::hasBlocks(job.size) && job.tail != HasherPool::Job::TailOnly)
+        job.blockMode = HasherPool::Job::AddBlocks;
+
+    return true;
+}
+
+bool Manager::planBlockCheck(CalcRun &run, HasherPool::Job &job)
+{
+    const BlockList stored = BlockList::fromString(TreeModel::itemFileBlockChecksums(job.index), run.blockDigestLen);
+
+    // no proper block digests, verified in full
+    if (!stored.isValid() || stored.blockSize() != Hasher::s_blockSize || stored.fileSize() != job.size)
+        return true;
+
+    // the blocks are not read if the file has been resized
+    const QFileInfo fi(job.filePath);
+
+    if (fi.exists() && fi.size() != job.size) {
+        setSizeChanged(run, job);
+        return false;
+    }
+
+    BlockCheck check;
+    check.stored = stored;
+
+    // re-checking a repaired file: only the blocks found changed before
+    if (run.mode.testFlag(CM_BlockCheck)) {
+        qint64 checked_size = 0;
+
+        for (const int block : TreeModel::itemFileChangedBlocks(job.index)) {
+            if (block >= 0 && block < stored.count()) {
+                job.blocks << block;
+                checked_size += stored.blockLength(block);
+            }
+        }
+
+        check.isFull = job.blocks.isEmpty();
+
+        if (!check.isFull)
+            m_proc->decreaseTotalSize(job.size - checked_size);
+    }
+
+    if (check.isFull) {
+        for (int block = 0; block < stored.count(); ++block)
+            job.blocks << block;
+    }
+
+    job.blockMode = HasherPool::Job::BlocksOnly;
+    run.blockChecks.insert(job.index, check);
+    return true;
+}
+
+void Manager::setSizeChanged(CalcRun &run, const HasherPool::Job &job)
+{
+    m_dataMaintainer->setFileStatus(job.index, FileStatus::Mismatched);
+    m_proc->decreaseTotalQueued();
+    m_proc->decreaseTotalSize(job.size);
+    ++run.numSizeChanged;
+    setMismatchFound(run);
+}
+
+void Manager::setMismatchFound(CalcRun &run)
+{
+    // the signal is only needed once
+    if (!run.isMismatchFound) {
+        emit mismatchFound();
+        run.isMismatchFound = true;
+    }
+}
+
+void Manager::applyResult(CalcRun &run, HasherPool &pool, const HasherPool::Result &res)
+{
+    const FileValues &fileVal = res.values;
+    const QString &sum = fileVal.defaultChecksum();
+
+    if (run.blockChecks.contains(res.index)) {
+        addBlockResult(run, res);
+        return;
+    }
+
+    // spot-check: the sample of a large file; a mismatch means the file has changed anyway
+    if (sum.isEmpty() && !fileVal.sampleChecksum.isEmpty()) {
+        m_proc->addDoneOne();
+        const bool isMatched = (fileVal.sampleChecksum == TreeModel::itemFileSampleChecksum(res.index));
+        m_dataMaintainer->setFileStatus(res.index, isMatched ? FileStatus::SampleMatched : FileStatus::Mismatched);
+
+        if (!isMatched)
+            setMismatchFound(run);
+        return;
+    }
+
+    // the grown file has changed before its previous end (not an error, not canceled), it's hashed in full
+    if (sum.isEmpty() && !(fileVal.status & FileStatus::CombCalcError) && run.tailJobs.contains(res.index)) {
+        HasherPool::Job job = run.tailJobs.take(res.index);
+        m_proc->changeTotalSize(m_proc->chunksSize().total + TailState::fromString(job.tailState).fileSize());
+        job.tail = HasherPool::Job::AddTail;
+        job.tailState.clear();
+        pool.addJob(job);
+        return;
+    }
+
+    if (sum.isEmpty()) {
+        // error handling
+        if (fileVal.status & FileStatus::CombCalcError) {
+            m_dataMaintainer->setFileStatus(res.index, fileVal.status);
+            Checkpoint::Item item;
+            item.status = fileVal.status;
+            m_checkpoint.add(TreeModel::getPath(res.index), item);
+        }
+
+        m_proc->decreaseTotalQueued();
+        m_proc->decreaseTotalSize(fileVal.size);
+        return;
+    }
+
+    // success
+    m_proc->addDoneOne();
+    applyChecksum(run, res);
+}
+
+void Manager::addBlockResult(CalcRun &run, const HasherPool::Result &res)
+{
+    const FileValues &fileVal = res.values;
+    BlockCheck &check = run.blockChecks[res.index];
+
+    if (fileVal.status & FileStatus::CombCalcError) {
+        check.error = fileVal.status;
+    } else {
+        for (int i = 0; i < res.blocks.size(); ++i) {
+            // the missing digests: the file has been shortened
+            if (fileVal.blockDigests.mid(i * run.blockDigestLen, run.blockDigestLen) != check.stored.digest(res.blocks.at(i)))
+                check.changed << res.blocks.at(i);
+        }
+
+        const qint64 cur_size = storage::fingerprintSize(fileVal.fingerprint);
+        if (cur_size >= 0 && cur_size != check.stored.fileSize())
+            check.isSizeChanged = true;
+    }
+
+    // the parts were hashed at different times, the file must be the same for all
+    if (check.done == 0)
+        check.fingerprint = fileVal.fingerprint;
+    else if (check.fingerprint != fileVal.fingerprint)
+        check.fingerprint.clear();
+
+    ++check.done;
+
+    if (--check.parts > 0)
+        return;
+
+    std::sort(check.changed.begin(), check.changed.end());
+
+    if (applyBlockCheck(res.index, check))
+        run.fingerprintsChanged = true;
+
+    const FileStatus check_status = TreeModel::itemFileStatus(res.index);
+
+    if (check_status & FileStatus::CombCalcError) {
+        m_proc->decreaseTotalQueued();
+        m_proc->decreaseTotalSize(fileVal.size);
+    } else {
+        m_proc->addDoneOne();
+    }
+
+    if (check_status == FileStatus::Mismatched) {
+        if (!check.changed.isEmpty() && ++run.numBlockMismatched <= s_maxBlockStats) {
+            run.stats << QString("Changed blocks of %1: %2")
+                             .arg(TreeModel::getPath(res.index),
+                                  BlockList::rangesToString(BlockList::ranges(check.changed,
+                                                                              check.stored.fileSize(),
+                                                                              check.stored.blockSize())));
+        }
+
+        setMismatchFound(run);
+    }
+
+    if (m_checkpoint.isOpen())
+        m_checkpoint.add(TreeModel::getPath(res.index), checkpointItem(res.index, run.isCreation));
+}
+
+void Manager::applyChecksum(CalcRun &run, const HasherPool::Result &res)
+{
+    const FileValues &fileVal = res.values;
+    const QString &sum = fileVal.defaultChecksum();
+    const QCryptographicHash::Algorithm main_algo = m_dataMaintainer->m_data->m_metadata.algorithm;
+
+    if (res.isLink) {
+        ++run.numLinks;
+        run.linksSize += fileVal.size;
+    }
+
+    // the timing of a small file is too short to be meaningful
+    if (!HasherPool::isSmallFile(fileVal.size)) {
+        m_dataMaintainer->setItemValue(res.index, Column::ColumnElapsed, fileVal.hash_time);
+        m_dataMaintainer->setItemValue(res.index, Column::ColumnSpeed, fileVal.hash_speed());
+    }
+
+    if (run.purpose == DM_FindMoved) {
+        if (m_dataMaintainer->tryMoved(res.index, sum))
+            m_dataMaintainer->setFingerprint(res.index, fileVal.fingerprint);
+        else
+            m_dataMaintainer->setFileStatus(res.index, run.status); // rollback status
+        return;
+    }
+
+    // != DM_FindMoved
+    const bool isMatched = m_dataMaintainer->updateChecksum(res.index, sum, fileVal.hash_algo);
+    m_dataMaintainer->setExtraChecksums(res.index, fileVal.extraChecksums);
+    m_dataMaintainer->setSampleChecksum(res.index, fileVal.sampleChecksum);
+
+    // of the computed checksum: the stored one if matched, the one to update it with otherwise
+    if (m_dataMaintainer->setTailState(res.index, fileVal.tailState) && isMatched)
+        run.fingerprintsChanged = true;
+
+    if (run.tailJobs.contains(res.index)) {
+        run.tailsSize += TailState::fromString(run.tailJobs.take(res.index).tailState).fileSize();
+        ++run.numTails;
+    }
+
+    if (isMatched && !fileVal.blockDigests.isEmpty()) {
+        const BlockList blocks(fileVal.size, Hasher::s_blockSize, fileVal.blockDigests, run.blockDigestLen);
+        m_dataMaintainer->setBlockChecksums(res.index, blocks.toString());
+    }
+
+    // the state of the file the stored checksum is known to be valid for
+    if (isMatched && m_dataMaintainer->setFingerprint(res.index, fileVal.fingerprint))
+        run.fingerprintsChanged = true;
+
+    if (isMatched && run.kind == Verification)
+        m_dataMaintainer->setChangedBlocks(res.index, QList<int>());
+
+    if (run.countAlgos)
+        ++run.verifiedBy[fileVal.hash_algo];
+
+    // to be confirmed by the main algorithm (::recheckFastMismatches)
+    if (!isMatched && run.kind == Verification && fileVal.hash_algo != main_algo)
+        run.fastMismatches << res.index;
+
+    if (!isMatched)
+        setMismatchFound(run);
+
+    if (m_checkpoint.isOpen())
+        m_checkpoint.add(TreeModel::getPath(res.index), checkpointItem(res.index, run.isCreation));
+}
+
+void Manager::addRunStats(CalcRun &run) const
+{
+    const MetaData &meta = m_dataMaintainer->m_data->m_metadata;
+
+    if (run.mode.testFlag(CM_SpotCheck)) {
+        run.stats << QString("Spot-check: %1 large files by a sample, the rest in full").arg(run.numSampled);
+
+        if (run.numNoSample > 0)
+            run.stats << QString("Spot-check: %1 large files skipped, no sample digests").arg(run.numNoSample);
+    }
+
+    if (run.numSizeChanged > 0)
+        run.stats << QString("%1 files changed in size, mismatched without reading").arg(run.numSizeChanged);
+
+    if (!run.blockChecks.isEmpty())
+        run.stats << QString("%1 large files verified by blocks").arg(run.blockChecks.size());
+
+    if (run.numLinks > 0)
+        run.stats << QString("Hard links: %1 paths not read, %2 saved").arg(run.numLinks).arg(format::dataSizeReadable(run.linksSize));
+
+    if (run.numTails > 0)
+        run.stats << QString("Grown files: %1 hashed from the previous end, %2 not read").arg(run.numTails).arg(format::dataSizeReadable(run.tailsSize));
+
+    if (run.numBlockMismatched > s_maxBlockStats)
+        run.stats << QString("Changed blocks: %1 more files").arg(run.numBlockMismatched - s_maxBlockStats);
+
+    if (!run.verifiedBy.isEmpty()) {
+        QStringList by_algo;
+        for (auto it = run.verifiedBy.constBegin(); it != run.verifiedBy.constEnd(); ++it)
+            by_algo << QString("%1: %2").arg(AlgoString::name(it.key())).arg(it.value());
+        run.stats << QStringLiteral(u"Verified by ") + by_algo.join(QStringLiteral(u", "));
+    }
+
+    // the hardware kernels or the Qt implementation
+    QStringList engines;
+    for (const QCryptographicHash::Algorithm algo : QList<QCryptographicHash::Algorithm>{ meta.algorithm }
+                                                        + meta.extraAlgorithms)
+        engines << AlgoString::name(algo) + QStringLiteral(u": ") + HashFunction::engineName(algo);
+    run.stats << QStringLiteral(u"Engine: ") + engines.join(QStringLiteral(u", "));
+
+    if (meta.algorithm == QCryptographicHash::Sha256 && meta.extraAlgorithms.isEmpty()
+        && Hasher::isMultiBufferPreferred())
+    {
+        run.stats << QString("Small files: SHA-256 multi-buffer, %1 lanes").arg(Sha::multiLanes());
+    }
+
+    const QString qos = m_qos.profile().toString();
+    if (!qos.isEmpty())
+        run.stats << QStringLiteral(u"QoS: ") + qos;
+}
+
+void Manager::sortByLayout(QQueue<HasherPool::Job> &jobs) const
+{
+    QStringList paths;
+    paths.reserve(jobs.size());
+
+    for (const HasherPool::Job &job : std::as_const(jobs))
+        paths << job.filePath;
+
+    const QList<int> order = storage::layoutOrder(paths);
+    QQueue<HasherPool::Job> sorted;
+    sorted.reserve(jobs.size());
+
+    for (const int ind : order)
+        sorted.enqueue(jobs.at(ind));
+
+    jobs = sorted;
+}
+
+QList<HasherPool::Job> Manager::blockJobs(const HasherPool::Job &job)
+{
+    QList<HasherPool::Job> parts;
+
+    for (int i = 0; i < job.blocks.size(); i += s_blocksPerPart) {
+        HasherPool::Job part = job;
+        part.blocks = job.blocks.mid(i, s_blocksPerPart);
+        parts.append(part);
+    }
+
+    return parts;
+}
+
+bool Manager::applyBlockCheck(const QModelIndex &index, const BlockCheck &check)
+{
+    if (check.error != FileStatus::NotSet) {
+        m_dataMaintainer->setFileStatus(index, check.error);
+        return false;
+    }
+
+    const bool isMatched = check.changed.isEmpty() && !check.isSizeChanged;
+
+    // the one computed by a previous full hashing may be outdated
+    if (!TreeModel::itemFileReChecksum(index).isEmpty())
+        m_dataMaintainer->setItemValue(index, Column::ColumnReChecksum);
+
+    m_dataMaintainer->setFileStatus(index, isMatched ? FileStatus::Matched : FileStatus::Mismatched);
+
+    // a partial re-check: the rest of the blocks were found unchanged by the previous one
+    m_dataMaintainer->setChangedBlocks(index, check.changed);
+
+    if (check.isFull && check.timer.isValid()) {
+        const qint64 elapsed = check.timer.elapsed();
+        m_dataMaintainer->setItemValue(index, Column::ColumnElapsed, elapsed);
+        const qint64 size = check.stored.fileSize();
+        m_dataMaintainer->setItemValue(index, Column::ColumnSpeed, (elapsed > 0) ? (size / elapsed) : size);
+    }
+
+    // the entire file is known to match the stored checksum
+    return isMatched && check.isFull && m_dataMaintainer->setFingerprint(index, check.fingerprint);
+}
+
 // info about folder (number of files and total size) or file (size)
 void Manager::getPathInfo(const QString &path)
 {
@@ -9,6 +9,10 @@
 #include <QObject>
 #include "datamaintainer.h"
 #include "hasher.h"
+#include "hasherpool.h"
+#include "qos.h"
+#include "checkpoint.h"
+#include "blocklist.h"
 #include "view.h"
 #include "procstate.h"
 #include "settings.h"
@@ -41,9 +45,22 @@ public:
         DM_PasteDigest = 1 << 5
     }; // enum DbMod
 
+    // how a calculateChecksums() run hashes the Queued items
+    enum CalcMode {
+        CM_Default = 0,
+        CM_Resume = 1 << 0,     // continues the existing checkpoint
+        CM_SpotCheck = 1 << 1,  // verifies the large files by their samples
+        CM_BlockCheck = 1 << 2, // verifies by the blocks, only the changed ones if known
+        CM_FullCheck = 1 << 3   // verifies by the main algorithm, not the fastest stored digest
+    }; // enum CalcMode
+    Q_DECLARE_FLAGS(CalcModes, CalcMode)
+
     DataMaintainer *m_dataMaintainer = new DataMaintainer(this);
     ProcState *m_proc = new ProcState(this);
 
+    // the hashing load limits; set by the GUI thread, may be changed during the process
+    Qos m_qos;
+
     template<typename Callable, typename... Args>
     void addTask(Callable&& _func, Args&&... _args)
     {
@@ -66,7 +83,8 @@ public:
     QString extractDigestFromFile(const QString &digestFile, bool showException = true);
 
 public slots:
-    void processFolderSha(const MetaData &metaData);
+    // 'resume': the results saved by the interrupted creation (checkpoint) are used
+    void processFolderSha(const MetaData &metaData, bool resume = false);
     void branchSubfolder(const QModelIndex &subfolder);
     void updateDatabase(const Manager::DbMod dest);
     void updateItemFile(const QModelIndex &fileIndex, Manager::DbMod job);
@@ -107,6 +125,17 @@ public slots:
     // check only selected file instead of full database verification
     void verifyFileItem(const QModelIndex &fileItemIndex);
 
+    // continues the interrupted verification of the current db from its checkpoint
+    void resumeVerification();
+
+    // a quick check of a random part of the files ("is it probably intact"): large files by their sample digests,
+    // the rest in full; the sampled results are SampleMatched, not Matched
+    void spotCheckFolderItem(const QModelIndex &folderItemIndex);
+
+    // an incremental check: the files in the same state (size, mtime, inode) as at their last match
+    // are Unchanged and not read, the rest are verified in full
+    void verifyChangedItems(const QModelIndex &folderItemIndex);
+
     // make a list of the file types contained in the folder, their number and size
     void folderContentsList(const QString &folderPath, bool filterCreation);
 
@@ -117,6 +146,56 @@ public slots:
 private:
     enum CalcKind : quint8 { Calculation, Verification };
 
+    // a large file verified by its block digests, in parts (HasherPool jobs) hashed in parallel
+    struct BlockCheck {
+        BlockList stored;
+        int parts = 0;          // not yet done
+        int done = 0;
+        bool isFull = true;     // all blocks, not only the ones found changed before
+        bool isSizeChanged = false;
+        QList<int> changed;     // the numbers of mismatched blocks
+        FileStatus error = FileStatus::NotSet;
+        QString fingerprint;    // the same of all parts, empty otherwise
+        QElapsedTimer timer;    // since the first part is queued to the pool
+    }; // struct BlockCheck
+
+    // the state of a calculateChecksums() run, shared by its job planning and result handling
+    struct CalcRun {
+        DbMod purpose = DM_AutoSelect;
+        FileStatus status = FileStatus::NotSet; // the one of the items queued
+        CalcModes mode;
+        CalcKind kind = Calculation;
+        bool isCreation = false;
+        bool addSamples = false;    // the sample digests of the large files are computed
+        bool addBlocks = false;     // ... the block digests
+        bool addTails = false;      // ... the hash states at their end; a grown file is hashed from it
+        bool countAlgos = false;    // multi-digest db verified: the number of files by each algorithm
+        int blockDigestLen = 0;     // the raw length
+        bool isMismatchFound = false;
+        bool fingerprintsChanged = false;
+
+        QHash<QModelIndex, BlockCheck> blockChecks;
+        QHash<QModelIndex, HasherPool::Job> tailJobs; // the ones to be hashed in full if the rest has changed
+        QList<QModelIndex> fastMismatches;            // the files found mismatched by a fast digest
+        QMap<QCryptographicHash::Algorithm, int> verifiedBy;
+
+        int numSizeChanged = 0;     // verified: the size differs from the one at the last match, not read
+        int numSampled = 0;
+        int numNoSample = 0;
+        int numBlockMismatched = 0;
+        int numLinks = 0;           // the hard links not read (HasherPool::Result::isLink)
+        qint64 linksSize = 0;
+        int numTails = 0;
+        qint64 tailsSize = 0;       // the previous contents of the grown files, not read
+        QStringList stats;          // run details for the result dialog
+    }; // struct CalcRun
+
+    // the blocks of a file per HasherPool job
+    static const int s_blocksPerPart = 64;
+
+    // the max number of files whose changed blocks are listed in the hashing stats
+    static const int s_maxBlockStats = 10;
+
     void queueTask(Task task);
     void sendDbUpdated();
 
@@ -124,25 +203,109 @@ private:
                         QCryptographicHash::Algorithm algo,
                         const CalcKind calckind = Calculation);
 
+    // all the 'algos' in a single pass, the first one is the main;
+    // 'addBlocks': the block digests of a large file (FileValues::blockDigests),
+    // 'addSample': its sample digest (FileValues::sampleChecksum)
+    FileValues hashFile(const QString &filePath,
+                        const QList<QCryptographicHash::Algorithm> &algos,
+                        const CalcKind calckind = Calculation,
+                        bool addBlocks = false,
+                        bool addSample = false);
+
     FileValues hashItem(const QModelIndex &ind,
-                        const CalcKind calckind = Calculation);
+                        const CalcKind calckind = Calculation,
+                        bool addBlocks = false,
+                        bool addSample = false);
 
+    // 'fastMismatches': the files found mismatched by a fast digest, to be confirmed (::recheckFastMismatches)
     int calculateChecksums(const FileStatus status,
-                           const QModelIndex &root = QModelIndex());
+                           const QModelIndex &root = QModelIndex(),
+                           const CalcModes mode = CM_Default,
+                           QList<QModelIndex> *fastMismatches = nullptr);
 
     int calculateChecksums(const DbMod purpose,
                            const FileStatus status,
-                           const QModelIndex &root = QModelIndex());
+                           const QModelIndex &root = QModelIndex(),
+                           const CalcModes mode = CM_Default,
+                           QList<QModelIndex> *fastMismatches = nullptr);
+
+    // sets up the job of a Queued item: the size check, the blocks, the tail and the sample;
+    // returns false if the file is not to be read (its status is set)
+    bool planJob(CalcRun &run, HasherPool::Job &job);
+
+    // a large file with the proper block digests is verified by them (Job::BlocksOnly);
+    // returns false if it has been resized
+    bool planBlockCheck(CalcRun &run, HasherPool::Job &job);
+
+    // the file is Mismatched without reading
+    void setSizeChanged(CalcRun &run, const HasherPool::Job &job);
+    void setMismatchFound(CalcRun &run);
+
+    // sets the result of a job taken from the 'pool'; a grown file changed before its previous end
+    // is queued to it again, to be hashed in full
+    void applyResult(CalcRun &run, HasherPool &pool, const HasherPool::Result &res);
+
+    // a part of the file verified by its blocks; the result is set when all parts are done
+    void addBlockResult(CalcRun &run, const HasherPool::Result &res);
+
+    // the computed checksum is added to the db item or verified against the stored one
+    void applyChecksum(CalcRun &run, const HasherPool::Result &res);
+
+    // the run details (CalcRun::stats) by its numbers
+    void addRunStats(CalcRun &run) const;
+
+    // ::verifyFolderItem, 'mode': CM_Resume to continue the checkpoint
+    void verifyFolder(const QModelIndex &folderItemIndex, FileStatus checkstatus, const CalcModes mode);
+
+    // imports the checksum from the item's digest file (*.shaX), if any
+    bool importDigestFile(const QModelIndex &fileIndex);
 
     void updateProgText(const CalcKind calckind, const QString &file);
 
+    // the file reading options from the Settings
+    Hasher::ReadOptions readOptions() const;
+
+    // the algorithms to hash the db item with: all the stored ones when adding,
+    // the main or the fastest available one (if allowed) when verifying
+    QList<QCryptographicHash::Algorithm> itemAlgorithms(const QModelIndex &fileIndex, const CalcKind calckind) const;
+
+    // verifying by the fastest digest, the last check of the entire db by the main algorithm
+    // is older than Settings::verify_full_days
+    bool isFullCheckDue() const;
+
+    // the files mismatched by a fast digest are verified again by the main algorithm: the mismatch is confirmed
+    // and the new checksum is known to update the db with; returns the number of such files
+    int recheckFastMismatches(const QList<QModelIndex> &mismatches, const QModelIndex &root);
+
+    // reorders the jobs (files of a single device) by their location on the disk
+    void sortByLayout(QQueue<HasherPool::Job> &jobs) const;
+
+    // sets the saved results to the items not yet processed; returns the number of applied ones
+    int applyCheckpoint(const Checkpoint &checkpoint);
+
+    // the processed item's result to be saved: its status and the values set to the model
+    static Checkpoint::Item checkpointItem(const QModelIndex &fileIndex, bool isCreation);
+
+    // the items checked before the verification of the entire db started (e.g. Unchanged),
+    // so they are not lost or redone if it's resumed
+    void addCheckedToCheckpoint();
+
+    // splits the job of a file verified by its blocks (job.blocks) into parts of 's_blocksPerPart'
+    static QList<HasherPool::Job> blockJobs(const HasherPool::Job &job);
+
+    // sets the result of a file verified by its blocks: the status, changed blocks and fingerprint;
+    // returns true if the fingerprint has changed
+    bool applyBlockCheck(const QModelIndex &index, const BlockCheck &check);
+
     // variables
     bool m_isViewFileSysytem;
     Settings *m_settings = nullptr;
     Files *m_files = new Files(this);
+    BufferPool m_bufferPool; // shared by all hashers
     Hasher m_shaCalc;
     QList<Task> m_taskQueue;
     QElapsedTimer m_elapsedTimer;
+    Checkpoint m_checkpoint; // the progress of the current creation or verification
 
     const QString k_movedDbWarning = QStringLiteral(
         u"The database file may have been moved or refers to an inaccessible location.");
@@ -164,8 +327,16 @@ signals:
     void mismatchFound();
     void taskAdded();
     void noAvailableItems();
+
+    // the db has the checkpoint of an interrupted verification
+    void checkpointFound(const QString &dbFilePath);
+
+    // the details of the last hashing run: read sizes etc.
+    void hashingStats(const QString &text);
 }; // class Manager
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Manager::CalcModes)
+
 using DbMod = Manager::DbMod;
 
 #endif // MANAGER_H
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "mapguard.h"
+
+#if defined(Q_OS_UNIX)
+#include <csignal>
+#include <csetjmp>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN) && defined(_MSC_VER)
+#include <windows.h>
+#endif
+
+namespace mapguard {
+
+#if defined(Q_OS_UNIX)
+// the jump target of the guarded call in progress in this thread, if any
+static thread_local sigjmp_buf *t_jumpBuf = nullptr;
+static struct sigaction s_prevAction;
+
+static void sigBusHandler(int sig, siginfo_t *info, void *ucontext)
+{
+    if (t_jumpBuf)
+        siglongjmp(*t_jumpBuf, 1);
+
+    // not a guarded access: the previous handler or the default action (termination)
+    if (s_prevAction.sa_flags & SA_SIGINFO) {
+        s_prevAction.sa_sigaction(sig, info, ucontext);
+    }
+    else if (s_prevAction.sa_handler != SIG_DFL && s_prevAction.sa_handler != SIG_IGN) {
+        s_prevAction.sa_handler(sig);
+    }
+    else {
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+}
+
+static void installHandler()
+{
+    static std::once_flag s_installed;
+
+    std::call_once(s_installed, []{
+        struct sigaction action = {};
+        action.sa_sigaction = sigBusHandler;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGBUS, &action, &s_prevAction);
+    });
+}
+
+bool isAvailable()
+{
+    return true;
+}
+
+bool call(void (*func)(void *), void *context)
+{
+    installHandler();
+
+    sigjmp_buf jumpBuf;
+    sigjmp_buf *prevJumpBuf = t_jumpBuf;
+
+    if (sigsetjmp(jumpBuf, 1) != 0) {
+        // returned from the handler
+        t_jumpBuf = prevJumpBuf;
+        return false;
+    }
+
+    t_jumpBuf = &jumpBuf;
+    func(context);
+    t_jumpBuf = prevJumpBuf;
+
+    return true;
+}
+
+void adviseSequential(const void *data, qint64 size)
+{
+    // the start address must be page aligned
+    static const quintptr s_pageSize = static_cast<quintptr>(sysconf(_SC_PAGESIZE));
+    const quintptr addr = reinterpret_cast<quintptr>(data);
+    const quintptr aligned = addr & ~(s_pageSize - 1);
+
+    posix_madvise(reinterpret_cast<void *>(aligned), static_cast<size_t>(size + (addr - aligned)), POSIX_MADV_SEQUENTIAL);
+}
+
+#elif defined(Q_OS_WIN) && defined(_MSC_VER)
+static int pageErrorFilter(unsigned long code)
+{
+    return (code == EXCEPTION_IN_PAGE_ERROR) ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH;
+}
+
+bool isAvailable()
+{
+    return true;
+}
+
+bool call(void (*func)(void *), void *context)
+{
+    __try {
+        func(context);
+    }
+    __except (pageErrorFilter(GetExceptionCode())) {
+        return false;
+    }
+
+    return true;
+}
+
+void adviseSequential(const void *, qint64)
+{}
+
+#else
+// no structured exception handling (e.g. MinGW): unguarded, the mapped reading is not used (Hasher)
+bool isAvailable()
+{
+    return false;
+}
+
+bool call(void (*func)(void *), void *context)
+{
+    func(context);
+    return true;
+}
+
+void adviseSequential(const void *, qint64)
+{}
+#endif
+
+} // namespace mapguard
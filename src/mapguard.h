@@ -0,0 +1,39 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef MAPGUARD_H
+#define MAPGUARD_H
+
+#include <QtGlobal>
+#include <type_traits>
+
+/* Access to the memory-mapped files.
+ * A mapped file truncated by another process or an I/O error while paging in raises SIGBUS
+ * (EXCEPTION_IN_PAGE_ERROR on Windows), which would terminate the app. The guarded call turns it
+ * into a return value. Only the thread that made the call is guarded, so the 'func' must not
+ * access the mapping from other threads.
+ */
+namespace mapguard {
+
+// the faults are caught on this platform (signals, SEH); otherwise the mapped files must not be read,
+// as a fault would terminate the app
+bool isAvailable();
+
+// calls the 'func(context)'; returns false if the mapped memory access fault occurred during the call
+bool call(void (*func)(void *), void *context);
+
+template <typename F>
+bool call(F &&func)
+{
+    using Func = std::remove_reference_t<F>;
+    return call([](void *context){ (*static_cast<Func*>(context))(); }, &func);
+}
+
+// hints the OS that the mapped range will be read sequentially (madvise), no-op where not supported
+void adviseSequential(const void *data, qint64 size);
+
+} // namespace mapguard
+
+#endif // MAPGUARD_H
@@ -20,10 +20,12 @@ MenuActions::MenuActions(QObject *parent)
     actionSetAlgoSha1->setCheckable(true);
     actionSetAlgoSha256->setCheckable(true);
     actionSetAlgoSha512->setCheckable(true);
+    actionSetAlgoBlake3->setCheckable(true);
 
     actionGroupSelectAlgo->addAction(actionSetAlgoSha1);
     actionGroupSelectAlgo->addAction(actionSetAlgoSha256);
     actionGroupSelectAlgo->addAction(actionSetAlgoSha512);
+    actionGroupSelectAlgo->addAction(actionSetAlgoBlake3);
 
     menuAlgo->addActions(actionGroupSelectAlgo->actions());
     menuCreateDigest->addActions(m_actionsMakeDigest);
@@ -90,6 +92,8 @@ void MenuActions::setActionsIcons()
     actionCheckItemSubfolder->setIcon(m_icons.icon(Icons::FolderSync));
     //actionCheckAllMod->setIcon(m_icons.icon(FileStatus::NotCheckedMod));
     actionCheckAll->setIcon(m_icons.icon(Icons::Start));
+    actionSpotCheck->setIcon(m_icons.icon(Icons::Scan));
+    actionCheckChanged->setIcon(m_icons.icon(Icons::Scan));
     actionCopyStoredChecksum->setIcon(m_icons.icon(Icons::Copy));
     actionCopyReChecksum->setIcon(m_icons.icon(Icons::Copy));
     actionBranchMake->setIcon(m_icons.icon(Icons::AddFork));
@@ -215,6 +219,9 @@ QMenu* MenuActions::menuAlgorithm(QCryptographicHash::Algorithm curAlgo)
     case QCryptographicHash::Sha512:
         actionSetAlgoSha512->setChecked(true);
         break;
+    case Algo::Blake3:
+        actionSetAlgoBlake3->setChecked(true);
+        break;
     default:
         actionSetAlgoSha256->setChecked(true);
         break;
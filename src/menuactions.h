@@ -57,10 +57,12 @@ public:
     QAction *actionProcessSha1File = new QAction(QStringLiteral(u"SHA-1 → *.sha1"), this);
     QAction *actionProcessSha256File = new QAction(QStringLiteral(u"SHA-256 → *.sha256"), this);
     QAction *actionProcessSha512File = new QAction(QStringLiteral(u"SHA-512 → *.sha512"), this);
+    QAction *actionProcessBlake3File = new QAction(QStringLiteral(u"BLAKE3 → *.blake3"), this);
     QAction *actionOpenDatabase = new QAction(QStringLiteral(u"Open Database"), this);
     QAction *actionCheckSumFile = new QAction(QStringLiteral(u"Check the Checksum"), this);
 
-    QList<QAction*> m_actionsMakeDigest { actionProcessSha1File, actionProcessSha256File, actionProcessSha512File };
+    QList<QAction*> m_actionsMakeDigest { actionProcessSha1File, actionProcessSha256File, actionProcessSha512File,
+                                          actionProcessBlake3File };
 
     // DB Model View
     QAction *actionCancelBackToFS = new QAction(QStringLiteral(u"Close the Database"), this);
@@ -79,6 +81,8 @@ public:
     QAction *actionBranchImport = new QAction(QStringLiteral(u"Import Branch"), this);
     QAction *actionCheckAll = new QAction(QStringLiteral(u"Check ALL available files"), this);
     QAction *actionCheckAllMod = new QAction(QStringLiteral(u"Check Modified files"), this);
+    QAction *actionSpotCheck = new QAction(QStringLiteral(u"Spot-check (by samples)"), this);
+    QAction *actionCheckChanged = new QAction(QStringLiteral(u"Check Changed files (incremental)"), this);
     QAction *actionCopyStoredChecksum = new QAction(QStringLiteral(u"Copy stored Checksum"), this);
     QAction *actionCopyReChecksum = new QAction(QStringLiteral(u"Copy ReChecksum"), this);
     QAction *actionExportSum = new QAction(QStringLiteral(u"Export to *.sha"), this);
@@ -105,6 +109,7 @@ public:
     QAction *actionSetAlgoSha1 = new QAction(QStringLiteral(u"SHA-1"), this);
     QAction *actionSetAlgoSha256 = new QAction(QStringLiteral(u"SHA-256"), this);
     QAction *actionSetAlgoSha512 = new QAction(QStringLiteral(u"SHA-512"), this);
+    QAction *actionSetAlgoBlake3 = new QAction(QStringLiteral(u"BLAKE3"), this);
     QActionGroup *actionGroupSelectAlgo = new QActionGroup(this);
 
     // Menu
@@ -44,6 +44,7 @@ void ModeSelector::connectActions()
     connect(m_menuAct->actionProcessSha1File, &QAction::triggered, this, [=]{ procSumFile(QCryptographicHash::Sha1); });
     connect(m_menuAct->actionProcessSha256File, &QAction::triggered, this, [=]{ procSumFile(QCryptographicHash::Sha256); });
     connect(m_menuAct->actionProcessSha512File, &QAction::triggered, this, [=]{ procSumFile(QCryptographicHash::Sha512); });
+    connect(m_menuAct->actionProcessBlake3File, &QAction::triggered, this, [=]{ procSumFile(Algo::Blake3); });
     connect(m_menuAct->actionOpenDatabase, &QAction::triggered, this, &ModeSelector::doWork);
     connect(m_menuAct->actionCheckSumFile , &QAction::triggered, this, &ModeSelector::doWork);
 
@@ -77,6 +78,8 @@ void ModeSelector::connectActions()
     connect(m_menuAct->actionCheckItemSubfolder, &QAction::triggered, this, &ModeSelector::verifyItem);
     connect(m_menuAct->actionCheckAll, &QAction::triggered, this, &ModeSelector::verifyDb);
     connect(m_menuAct->actionCheckAllMod, &QAction::triggered, this, &ModeSelector::verifyModified);
+    connect(m_menuAct->actionSpotCheck, &QAction::triggered, this, &ModeSelector::spotCheck);
+    connect(m_menuAct->actionCheckChanged, &QAction::triggered, this, &ModeSelector::verifyChanged);
     connect(m_menuAct->actionCopyStoredChecksum, &QAction::triggered, this, [=]{ copyDataToClipboard(Column::ColumnChecksum); });
     connect(m_menuAct->actionCopyReChecksum, &QAction::triggered, this, [=]{ copyDataToClipboard(Column::ColumnReChecksum); });
     connect(m_menuAct->actionBranchMake, &QAction::triggered, this, &ModeSelector::branchSubfolder);
@@ -100,6 +103,7 @@ void ModeSelector::connectActions()
     connect(m_menuAct->actionSetAlgoSha1, &QAction::triggered, this, [=]{ m_settings->setAlgorithm(QCryptographicHash::Sha1); });
     connect(m_menuAct->actionSetAlgoSha256, &QAction::triggered, this, [=]{ m_settings->setAlgorithm(QCryptographicHash::Sha256); });
     connect(m_menuAct->actionSetAlgoSha512, &QAction::triggered, this, [=]{ m_settings->setAlgorithm(QCryptographicHash::Sha512); });
+    connect(m_menuAct->actionSetAlgoBlake3, &QAction::triggered, this, [=]{ m_settings->setAlgorithm(Algo::Blake3); });
 
     // recent files menu
     connect(m_menuAct->menuOpenRecent, &QMenu::triggered, this, &ModeSelector::openRecentDatabase);
@@ -529,6 +533,20 @@ void ModeSelector::verifyModified()
     verifyItems(QModelIndex(), FileStatus::NotCheckedMod);
 }
 
+void ModeSelector::spotCheck()
+{
+    stopProcess();
+    m_view->setViewSource();
+    m_manager->addTask(&Manager::spotCheckFolderItem, QModelIndex());
+}
+
+void ModeSelector::verifyChanged()
+{
+    stopProcess();
+    m_view->setViewSource();
+    m_manager->addTask(&Manager::verifyChangedItems, QModelIndex());
+}
+
 void ModeSelector::verifyItems(const QModelIndex &root, FileStatus status)
 {
     stopProcess();
@@ -631,6 +649,12 @@ void ModeSelector::processFolderChecksums(const FilterRule &filter, const QStrin
     metaData.workDir = m_view->m_lastPathFS;
     metaData.algorithm = m_settings->algorithm();
     metaData.filter = filter;
+
+    for (const QCryptographicHash::Algorithm algo : std::as_const(m_settings->extra_algorithms)) {
+        if (algo != metaData.algorithm)
+            metaData.extraAlgorithms << algo;
+    }
+
     metaData.dbFilePath = composeDbFilePath();
     metaData.dbFileState = DbFileState::NoFile;
     metaData.comment = comment;
@@ -638,7 +662,13 @@ void ModeSelector::processFolderChecksums(const FilterRule &filter, const QStrin
     if (m_settings->dbFlagConst)
         metaData.flags |= MetaData::FlagConst;
 
-    m_manager->addTask(&Manager::processFolderSha, metaData);
+    if (m_settings->dbFlagSamples)
+        metaData.flags |= MetaData::FlagSamples;
+
+    if (m_settings->dbFlagBlocks)
+        metaData.flags |= MetaData::FlagBlocks;
+
+    m_manager->addTask(&Manager::processFolderSha, metaData, resumeCreationPrompt(metaData));
 }
 
 bool ModeSelector::isSelectedCreateDb()
@@ -676,6 +706,32 @@ bool ModeSelector::overwriteDbPrompt()
     return (ret == QMessageBox::Save);
 }
 
+bool ModeSelector::resumeCreationPrompt(const MetaData &metaData)
+{
+    Checkpoint::Kind kind;
+    QCryptographicHash::Algorithm algo;
+
+    if (!m_settings->hashing_checkpoints
+        || !Checkpoint::readInfo(metaData.dbFilePath, kind, algo)
+        || kind != Checkpoint::Creation
+        || algo != metaData.algorithm)
+    {
+        return false;
+    }
+
+    QMessageBox msgBox(m_view);
+    msgBox.setWindowTitle("Interrupted creation detected");
+    msgBox.setText("The creation of the database was interrupted:\n" + pathstr::entryName(metaData.dbFilePath));
+    msgBox.setInformativeText("Do you want to resume it, skipping the files already processed, or start over?");
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    msgBox.setDefaultButton(QMessageBox::Yes);
+    msgBox.setIconPixmap(m_icons.pixmap(Icons::Database));
+    msgBox.button(QMessageBox::Yes)->setText("Resume");
+    msgBox.button(QMessageBox::No)->setText("Start over");
+
+    return (msgBox.exec() == QMessageBox::Yes);
+}
+
 bool ModeSelector::emptyFolderPrompt()
 {
     if (Files::isEmptyFolder(m_view->m_lastPathFS)) {
@@ -945,6 +1001,8 @@ void ModeSelector::createContextMenu_ViewDb(const QPoint &point)
             viewContextMenu->addAction(m_menuAct->actionCheckAllMod);
 
         viewContextMenu->addAction(m_menuAct->actionCheckAll);
+        viewContextMenu->addAction(m_menuAct->actionCheckChanged);
+        viewContextMenu->addAction(m_menuAct->actionSpotCheck);
 
         if (!isDbConst() && nums.contains(FileStatus::CombUpdatable))
             viewContextMenu->addMenu(m_menuAct->menuUpdateDb(nums));
@@ -72,6 +72,12 @@ public:
     void checkFile(const QString &filePath, const QString &checkSum);
     void verify(const QModelIndex index = QModelIndex());
     void verifyModified();
+
+    // a random part of the files, the large ones by their sample digests
+    void spotCheck();
+
+    // only the files whose size, mtime or inode has changed since their last match
+    void verifyChanged();
     void verifyItems(const QModelIndex &root, FileStatus status);
     void branchSubfolder();
 
@@ -85,6 +91,7 @@ public:
     bool promptProcessAbort();
     bool overwriteDbPrompt();
     bool emptyFolderPrompt();
+    bool resumeCreationPrompt(const MetaData &metaData);
 
     void procSumFile(QCryptographicHash::Algorithm algo);
     void verifyItem();
@@ -112,9 +112,9 @@ void ProcState::isFinished()
 }
 
 // add this processed piece(chunk), calculate total done size and emit ::percentageChanged
-void ProcState::addChunk(int chunk)
+void ProcState::addChunk(qint64 chunk)
 {
-    if (!chunks_size_.isSet()) // chunks_size_.total == 0
+    if (!chunks_size_.isSet() || chunk <= 0) // chunks_size_.total == 0
         return;
 
     if (!chunks_size_.hasChunks()) // chunks_size_.done == 0
@@ -68,7 +68,7 @@ public:
     Chunks<int> chunksQueue() const;
 
 public slots:
-    void addChunk(int chunk);
+    void addChunk(qint64 chunk);
 
 private:
     void startProgress();
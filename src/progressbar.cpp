@@ -20,6 +20,11 @@ void ProgressBar::setProcState(const ProcState *proc)
     m_proc = proc;
 }
 
+void ProgressBar::setQos(const Qos *qos)
+{
+    m_qos = qos;
+}
+
 void ProgressBar::start()
 {
     setProgEnabled(true);
@@ -55,6 +60,13 @@ void ProgressBar::updateProgressInfo()
                          % Lit::s_sepStick
                          % progTimeLeft();
 
+        // the profile may be changed during the process
+        if (m_qos) {
+            const QString qos = m_qos->profile().toString();
+            if (!qos.isEmpty())
+                format += Lit::s_sepStick % QStringLiteral(u"QoS: ") % qos;
+        }
+
         setFormat(format);
     } else {
         finish();
@@ -10,6 +10,7 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include "procstate.h"
+#include "qos.h"
 
 class ProgressBar : public QProgressBar
 {
@@ -19,6 +20,9 @@ public:
     explicit ProgressBar(QWidget *parent = nullptr);
     void setProcState(const ProcState *proc);
 
+    // the active QoS limits are shown with the progress
+    void setQos(const Qos *qos);
+
 public slots:
     void start();
     void finish();
@@ -31,6 +35,7 @@ private:
     QString progSpeed() const;
 
     const ProcState *m_proc = nullptr;
+    const Qos *m_qos = nullptr;
     QTimer *m_timer = new QTimer(this);
     QElapsedTimer m_elapsedTimer;
 
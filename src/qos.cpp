@@ -0,0 +1,138 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "qos.h"
+#include "procstate.h"
+#include <QThread>
+#include <QStringList>
+
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// linux/ioprio.h is not always installed
+#define VER_IOPRIO_WHO_PROCESS 1
+#define VER_IOPRIO_CLASS_SHIFT 13
+#define VER_IOPRIO_CLASS_NONE 0
+#define VER_IOPRIO_CLASS_BE 2
+#define VER_IOPRIO_CLASS_IDLE 3
+#endif
+
+bool Qos::Profile::isLimited() const
+{
+    return ioClass != IoDefault || bandwidth > 0 || threads > 0;
+}
+
+QString Qos::Profile::toString() const
+{
+    QStringList res;
+
+    if (ioClass == IoIdle)
+        res << QStringLiteral(u"idle I/O");
+    else if (ioClass == IoBestEffort)
+        res << QStringLiteral(u"I/O level ") + QString::number(ioLevel);
+
+    if (bandwidth > 0)
+        res << QString::number(bandwidth) + QStringLiteral(u" MiB/s");
+
+    if (threads > 0)
+        res << QString::number(threads) + (threads == 1 ? QStringLiteral(u" thread") : QStringLiteral(u" threads"));
+
+    return res.join(QStringLiteral(u", "));
+}
+
+bool Qos::Profile::operator==(const Profile &other) const
+{
+    return ioClass == other.ioClass
+           && ioLevel == other.ioLevel
+           && bandwidth == other.bandwidth
+           && threads == other.threads;
+}
+
+void Qos::setProfile(const Profile &profile)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (profile == m_profile)
+        return;
+
+    m_profile = profile;
+    m_profile.ioLevel = qBound(0, profile.ioLevel, 7);
+
+    // starting with a full bucket
+    m_tokens = m_profile.bandwidth * 1048576.0 * s_burstSeconds;
+    m_refillTimer.start();
+
+    m_threadLimit.store(qMax(0, m_profile.threads), std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_release);
+}
+
+Qos::Profile Qos::profile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_profile;
+}
+
+int Qos::generation() const
+{
+    return m_generation.load(std::memory_order_acquire);
+}
+
+int Qos::threadLimit() const
+{
+    return m_threadLimit.load(std::memory_order_relaxed);
+}
+
+bool Qos::applyIoPriority(const Profile &profile)
+{
+#if defined(Q_OS_LINUX) && defined(SYS_ioprio_set)
+    int value = VER_IOPRIO_CLASS_NONE << VER_IOPRIO_CLASS_SHIFT;
+
+    if (profile.ioClass == IoIdle)
+        value = VER_IOPRIO_CLASS_IDLE << VER_IOPRIO_CLASS_SHIFT;
+    else if (profile.ioClass == IoBestEffort)
+        value = (VER_IOPRIO_CLASS_BE << VER_IOPRIO_CLASS_SHIFT) | qBound(0, profile.ioLevel, 7);
+
+    // who == 0: the calling thread; the threads it creates inherit the priority
+    return ::syscall(SYS_ioprio_set, VER_IOPRIO_WHO_PROCESS, 0, value) == 0;
+#else
+    Q_UNUSED(profile)
+    return false;
+#endif
+}
+
+void Qos::consume(qint64 bytes, const ProcState *proc)
+{
+    const int generation = this->generation();
+    qint64 waitMs = 0;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_profile.bandwidth <= 0)
+            return;
+
+        const double rate = m_profile.bandwidth * 1048576.0; // bytes per second
+        const double burst = rate * s_burstSeconds;
+
+        m_tokens = qMin(burst, m_tokens + rate * m_refillTimer.nsecsElapsed() / 1e9);
+        m_refillTimer.restart();
+
+        // the debt is paid by waiting, the reads of other threads are queued behind it
+        m_tokens -= bytes;
+
+        if (m_tokens < 0)
+            waitMs = qint64(-m_tokens / rate * 1000);
+    }
+
+    while (waitMs > 0) {
+        if ((proc && proc->isCanceled()) || generation != this->generation())
+            return;
+
+        const qint64 slice = qMin<qint64>(waitMs, s_waitSliceMs);
+        QThread::msleep(slice);
+        waitMs -= slice;
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef QOS_H
+#define QOS_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+
+class ProcState;
+
+/* The limits of the hashing load, so the verification can run in the background
+ * without slowing down the other users of the disks and CPU:
+ * the I/O priority class of the hashing threads (Linux), the read bandwidth cap (token bucket)
+ * and the max number of hashing threads.
+ * Thread-safe: the profile may be changed by the GUI thread while the hashing is in progress,
+ * the workers pick it up with their next file.
+ */
+class Qos
+{
+public:
+    enum IoClass : quint8 {
+        IoDefault = 0,      // by the process priority (nice)
+        IoBestEffort = 1,   // the level (0 highest - 7 lowest) among the other best-effort processes
+        IoIdle = 2          // the disk is read only when no one else needs it
+    }; // enum IoClass
+
+    struct Profile {
+        IoClass ioClass = IoDefault;
+        int ioLevel = 4;
+        int bandwidth = 0;  // MiB/s, 0: no limit
+        int threads = 0;    // 0: no limit
+
+        bool isLimited() const;
+
+        // "idle I/O, 50 MiB/s, 2 threads"; empty if not limited
+        QString toString() const;
+
+        bool operator==(const Profile &other) const;
+        bool operator!=(const Profile &other) const { return !(*this == other); }
+    }; // struct Profile
+
+    void setProfile(const Profile &profile);
+    Profile profile() const;
+
+    // changed with each new profile
+    int generation() const;
+
+    // the max number of hashing threads, 0: no limit
+    int threadLimit() const;
+
+    // sets the I/O priority of the calling thread; returns false if not supported
+    static bool applyIoPriority(const Profile &profile);
+
+    // 'bytes' have been read: waits while the read bandwidth is over the cap;
+    // returns at once if there is no cap or the 'proc' is canceled
+    void consume(qint64 bytes, const ProcState *proc = nullptr);
+
+private:
+    // the tokens (bytes) accumulated while idle, by seconds of the bandwidth
+    static constexpr double s_burstSeconds = 0.5;
+
+    // the wait is split to check for cancellation and the profile changes
+    static const int s_waitSliceMs = 100;
+
+    Profile m_profile;
+    std::atomic<int> m_generation { 0 };
+    std::atomic<int> m_threadLimit { 0 };
+
+    double m_tokens = 0;
+    QElapsedTimer m_refillTimer;
+
+    mutable QMutex m_mutex;
+}; // class Qos
+
+#endif // QOS_H
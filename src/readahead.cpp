@@ -0,0 +1,88 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "readahead.h"
+
+ReadAhead::ReadAhead(QFile *file, BufferPool *pool, int chunkSize, int buffers)
+    : m_file(file), m_chunkSize(chunkSize)
+{
+    m_slots.resize(qMax(2, buffers));
+
+    for (Slot &slot : m_slots)
+        slot.buffer = pool->acquire(chunkSize);
+
+    m_reader = QThread::create([this]{ run(); });
+    m_reader->setObjectName(QStringLiteral(u"ReadAhead"));
+    m_reader->start();
+}
+
+ReadAhead::~ReadAhead()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        m_slotFreed.wakeAll();
+    }
+
+    m_reader->wait();
+    delete m_reader;
+}
+
+qint64 ReadAhead::next(const char **data)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const Slot &slot = m_slots[m_current];
+
+    while (!slot.filled)
+        m_slotFilled.wait(&m_mutex);
+
+    *data = slot.buffer.data();
+    return slot.size;
+}
+
+void ReadAhead::release()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_slots[m_current].filled = false;
+    m_current = (m_current + 1) % static_cast<int>(m_slots.size());
+    m_slotFreed.wakeOne();
+}
+
+void ReadAhead::run()
+{
+    const int number = static_cast<int>(m_slots.size());
+
+    for (int i = 0; ; i = (i + 1) % number) {
+        char *buffer = nullptr;
+
+        {
+            QMutexLocker locker(&m_mutex);
+
+            while (m_slots[i].filled && !m_stop)
+                m_slotFreed.wait(&m_mutex);
+
+            if (m_stop)
+                return;
+
+            buffer = m_slots[i].buffer.data();
+        }
+
+        // the slot is not filled, so it's not accessed by the consumer while reading
+        qint64 size = m_file->read(buffer, m_chunkSize);
+
+        if (size == 0 && !m_file->atEnd())
+            size = -1;
+
+        QMutexLocker locker(&m_mutex);
+        m_slots[i].size = size;
+        m_slots[i].filled = true;
+        m_slotFilled.wakeOne();
+
+        if (size <= 0)
+            return;
+    }
+}
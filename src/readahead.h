@@ -0,0 +1,56 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <vector>
+#include "bufferpool.h"
+
+/* Reads the file in a separate thread into a ring of buffers,
+ * so the next chunks are already in flight while the current one is being hashed.
+ * The file must be opened; it's only read by the reader thread until this object is destroyed.
+ * The buffers are taken from the pool and returned on destruction.
+ *
+ * Usage: ::next --> process the data --> ::release, until ::next returns 0 (end of file) or -1 (read error).
+ */
+class ReadAhead
+{
+public:
+    ReadAhead(QFile *file, BufferPool *pool, int chunkSize, int buffers);
+    ~ReadAhead(); // stops the reader and waits for it
+
+    // waits for the next filled buffer; returns the data size, 0 at the end of file, -1 on read error
+    qint64 next(const char **data);
+
+    // the buffer returned by the last ::next may be refilled
+    void release();
+
+private:
+    struct Slot {
+        BufferPool::Buffer buffer;
+        qint64 size = 0;
+        bool filled = false;
+    }; // struct Slot
+
+    void run(); // reader thread loop
+
+    QFile *m_file = nullptr;
+    const int m_chunkSize;
+    std::vector<Slot> m_slots; // the buffers are move-only
+    int m_current = 0; // the slot being processed by the consumer
+    bool m_stop = false;
+
+    QMutex m_mutex;
+    QWaitCondition m_slotFilled;
+    QWaitCondition m_slotFreed;
+    QThread *m_reader = nullptr;
+}; // class ReadAhead
+
+#endif // READAHEAD_H
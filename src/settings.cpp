@@ -8,6 +8,7 @@
 #include <QSettings>
 #include "tools.h"
 #include "dbfileextension.h"
+#include "algostring.h"
 
 const QString Settings::s_key_algo = QStringLiteral(u"algorithm");
 const QString Settings::s_key_dbPrefix = QStringLiteral(u"dbPrefix");
@@ -16,11 +17,17 @@ const QString Settings::s_key_addWorkDir = QStringLiteral(u"addWorkDirToFilename
 const QString Settings::s_key_isLongExt = QStringLiteral(u"isLongExtension");
 const QString Settings::s_key_saveVerifDate = QStringLiteral(u"saveVerifDate");
 const QString Settings::s_key_dbFlagConst = QStringLiteral(u"dbFlagConst");
+const QString Settings::s_key_dbFlagSamples = QStringLiteral(u"dbFlagSamples");
+const QString Settings::s_key_dbFlagBlocks = QStringLiteral(u"dbFlagBlocks");
 const QString Settings::s_key_instantSaving = QStringLiteral(u"instantSaving");
 const QString Settings::s_key_considerDateModified = QStringLiteral(u"considerDateModified");
 const QString Settings::s_key_detectMoved = QStringLiteral(u"detectMoved");
 const QString Settings::s_key_allowPasteIntoDb = QStringLiteral(u"allowPasteIntoDb");
 const QString Settings::s_key_importSumsWhenItemAdding = QStringLiteral(u"importSumsWhenItemAdding");
+const QString Settings::s_key_extraAlgorithms = QStringLiteral(u"extraAlgorithms");
+const QString Settings::s_key_verifyFastestDigest = QStringLiteral(u"verifyFastestDigest");
+const QString Settings::s_key_verifyFullDays = QStringLiteral(u"verifyFullDays");
+const QString Settings::s_key_spotCheckPercent = QStringLiteral(u"spotCheckPercent");
 
 // history
 const QString Settings::s_key_history_lastFsPath = QStringLiteral(u"history/lastFsPath");
@@ -41,6 +48,21 @@ const QString Settings::s_key_filter_editable_exts = QStringLiteral(u"filter/edi
 const QString Settings::s_key_filter_ignore_unpermitted = QStringLiteral(u"filter/ignore_unpermitted");
 const QString Settings::s_key_filter_ignore_symlinks = QStringLiteral(u"filter/ignore_symlinks");
 
+// hashing
+const QString Settings::s_key_hashing_threads = QStringLiteral(u"hashing/threads");
+const QString Settings::s_key_hashing_mmap = QStringLiteral(u"hashing/mmap");
+const QString Settings::s_key_hashing_cache_friendly = QStringLiteral(u"hashing/cache_friendly");
+const QString Settings::s_key_hashing_queue_depth = QStringLiteral(u"hashing/queue_depth");
+const QString Settings::s_key_hashing_adaptive_chunk = QStringLiteral(u"hashing/adaptive_chunk");
+const QString Settings::s_key_hashing_per_device = QStringLiteral(u"hashing/per_device");
+const QString Settings::s_key_hashing_layout_order = QStringLiteral(u"hashing/layout_order");
+const QString Settings::s_key_hashing_checkpoints = QStringLiteral(u"hashing/checkpoints");
+const QString Settings::s_key_hashing_resume_grown = QStringLiteral(u"hashing/resume_grown");
+const QString Settings::s_key_qos_io_class = QStringLiteral(u"qos/io_class");
+const QString Settings::s_key_qos_io_level = QStringLiteral(u"qos/io_level");
+const QString Settings::s_key_qos_bandwidth = QStringLiteral(u"qos/bandwidth");
+const QString Settings::s_key_qos_threads = QStringLiteral(u"qos/threads");
+
 Settings::Settings(QObject *parent)
     : QObject{parent}
 {}
@@ -104,12 +126,23 @@ void Settings::saveSettings()
     storedSettings.setValue(s_key_isLongExt, isLongExtension);
     storedSettings.setValue(s_key_saveVerifDate, saveVerificationDateTime);
     storedSettings.setValue(s_key_dbFlagConst, dbFlagConst);
+    storedSettings.setValue(s_key_dbFlagSamples, dbFlagSamples);
+    storedSettings.setValue(s_key_dbFlagBlocks, dbFlagBlocks);
     storedSettings.setValue(s_key_instantSaving, instantSaving);
     storedSettings.setValue(s_key_considerDateModified, considerDateModified);
     storedSettings.setValue(s_key_detectMoved, detectMoved);
     storedSettings.setValue(s_key_allowPasteIntoDb, allowPasteIntoDb);
     storedSettings.setValue(s_key_importSumsWhenItemAdding, m_importSumsWhenItemAdding);
 
+    QStringList extraAlgos;
+    for (const QCryptographicHash::Algorithm algo : std::as_const(extra_algorithms))
+        extraAlgos << AlgoString::name(algo);
+
+    storedSettings.setValue(s_key_extraAlgorithms, extraAlgos);
+    storedSettings.setValue(s_key_verifyFastestDigest, verify_fastest_digest);
+    storedSettings.setValue(s_key_verifyFullDays, verify_full_days);
+    storedSettings.setValue(s_key_spotCheckPercent, spot_check_percent);
+
     // filter
     storedSettings.setValue(s_key_filter_mode, filter_mode);
     storedSettings.setValue(s_key_filter_last_exts, filter_last_exts);
@@ -120,6 +153,21 @@ void Settings::saveSettings()
     storedSettings.setValue(s_key_filter_ignore_unpermitted, filter_ignore_unpermitted);
     storedSettings.setValue(s_key_filter_ignore_symlinks, filter_ignore_symlinks);
 
+    // hashing
+    storedSettings.setValue(s_key_hashing_threads, hashing_threads);
+    storedSettings.setValue(s_key_hashing_mmap, hashing_mmap);
+    storedSettings.setValue(s_key_hashing_cache_friendly, hashing_cache_friendly);
+    storedSettings.setValue(s_key_hashing_queue_depth, hashing_queue_depth);
+    storedSettings.setValue(s_key_hashing_adaptive_chunk, hashing_adaptive_chunk);
+    storedSettings.setValue(s_key_hashing_per_device, hashing_per_device);
+    storedSettings.setValue(s_key_hashing_layout_order, hashing_layout_order);
+    storedSettings.setValue(s_key_hashing_checkpoints, hashing_checkpoints);
+    storedSettings.setValue(s_key_hashing_resume_grown, hashing_resume_grown);
+    storedSettings.setValue(s_key_qos_io_class, qos_io_class);
+    storedSettings.setValue(s_key_qos_io_level, qos_io_level);
+    storedSettings.setValue(s_key_qos_bandwidth, qos_bandwidth);
+    storedSettings.setValue(s_key_qos_threads, qos_threads);
+
     // recent files
     storedSettings.setValue(s_key_history_recentDbFiles, recentFiles);
 
@@ -147,12 +195,26 @@ void Settings::loadSettings()
     isLongExtension = storedSettings.value(s_key_isLongExt, defaults.isLongExtension).toBool();
     saveVerificationDateTime = storedSettings.value(s_key_saveVerifDate, defaults.saveVerificationDateTime).toBool();
     dbFlagConst = storedSettings.value(s_key_dbFlagConst, defaults.dbFlagConst).toBool();
+    dbFlagSamples = storedSettings.value(s_key_dbFlagSamples, defaults.dbFlagSamples).toBool();
+    dbFlagBlocks = storedSettings.value(s_key_dbFlagBlocks, defaults.dbFlagBlocks).toBool();
     instantSaving = storedSettings.value(s_key_instantSaving, defaults.instantSaving).toBool();
     considerDateModified = storedSettings.value(s_key_considerDateModified, defaults.considerDateModified).toBool();
     detectMoved = storedSettings.value(s_key_detectMoved, defaults.detectMoved).toBool();
     allowPasteIntoDb = storedSettings.value(s_key_allowPasteIntoDb, defaults.allowPasteIntoDb).toBool();
     m_importSumsWhenItemAdding = storedSettings.value(s_key_importSumsWhenItemAdding, defaults.m_importSumsWhenItemAdding).toBool();
 
+    extra_algorithms.clear();
+    const QStringList extraAlgos = storedSettings.value(s_key_extraAlgorithms).toStringList();
+    for (const QString &strAlgo : extraAlgos) {
+        const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(strAlgo);
+        if (algo)
+            extra_algorithms << algo;
+    }
+
+    verify_fastest_digest = storedSettings.value(s_key_verifyFastestDigest, defaults.verify_fastest_digest).toBool();
+    verify_full_days = storedSettings.value(s_key_verifyFullDays, defaults.verify_full_days).toInt();
+    spot_check_percent = storedSettings.value(s_key_spotCheckPercent, defaults.spot_check_percent).toInt();
+
     // filter
     filter_mode = static_cast<FilterMode>(storedSettings.value(s_key_filter_mode, FilterMode::NotSet).toInt());
     filter_last_exts = storedSettings.value(s_key_filter_last_exts).toStringList();
@@ -163,6 +225,21 @@ void Settings::loadSettings()
     filter_ignore_unpermitted = storedSettings.value(s_key_filter_ignore_unpermitted, defaults.filter_ignore_unpermitted).toBool();
     filter_ignore_symlinks = storedSettings.value(s_key_filter_ignore_symlinks, defaults.filter_ignore_symlinks).toBool();
 
+    // hashing
+    hashing_threads = storedSettings.value(s_key_hashing_threads, defaults.hashing_threads).toInt();
+    hashing_mmap = storedSettings.value(s_key_hashing_mmap, defaults.hashing_mmap).toBool();
+    hashing_cache_friendly = storedSettings.value(s_key_hashing_cache_friendly, defaults.hashing_cache_friendly).toBool();
+    hashing_queue_depth = storedSettings.value(s_key_hashing_queue_depth, defaults.hashing_queue_depth).toInt();
+    hashing_adaptive_chunk = storedSettings.value(s_key_hashing_adaptive_chunk, defaults.hashing_adaptive_chunk).toBool();
+    hashing_per_device = storedSettings.value(s_key_hashing_per_device, defaults.hashing_per_device).toBool();
+    hashing_layout_order = storedSettings.value(s_key_hashing_layout_order, defaults.hashing_layout_order).toBool();
+    hashing_checkpoints = storedSettings.value(s_key_hashing_checkpoints, defaults.hashing_checkpoints).toBool();
+    hashing_resume_grown = storedSettings.value(s_key_hashing_resume_grown, defaults.hashing_resume_grown).toBool();
+    qos_io_class = storedSettings.value(s_key_qos_io_class, defaults.qos_io_class).toInt();
+    qos_io_level = storedSettings.value(s_key_qos_io_level, defaults.qos_io_level).toInt();
+    qos_bandwidth = storedSettings.value(s_key_qos_bandwidth, defaults.qos_bandwidth).toInt();
+    qos_threads = storedSettings.value(s_key_qos_threads, defaults.qos_threads).toInt();
+
     // recent files
     recentFiles = storedSettings.value(s_key_history_recentDbFiles).toStringList();
 
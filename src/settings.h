@@ -37,11 +37,26 @@ public:
     bool saveVerificationDateTime = false;
     bool instantSaving = false;
     bool dbFlagConst = false;
+    bool dbFlagSamples = false; // new databases store the sample digests of large files (spot-checks)
+    bool dbFlagBlocks = false;  // ... the block digests of large files (the changed parts of a mismatched file)
     bool considerDateModified = true;
     bool detectMoved = false;
     bool allowPasteIntoDb = false;
     bool m_importSumsWhenItemAdding = false; // TODO: unify var names
 
+    // multi-digest databases: the algorithms hashed along with the main one
+    QList<QCryptographicHash::Algorithm> extra_algorithms;
+
+    // the multi-digest databases are verified by the fastest of the stored algorithms
+    bool verify_fastest_digest = false;
+
+    // ...and by the main one, if the last such (full) check of the entire db is older than that, days; 0: never
+    // (the files mismatched by a fast digest are always re-checked by the main algorithm)
+    int verify_full_days = 0;
+
+    // the spot-check verifies a random part of the files, %
+    int spot_check_percent = 100;
+
     FilterMode filter_mode = FilterMode::NotSet;
     QStringList filter_last_exts;
     bool filter_editable_exts = false;
@@ -51,6 +66,46 @@ public:
     bool filter_ignore_unpermitted = true;
     bool filter_ignore_symlinks = true;
 
+    // the number of files hashed simultaneously, 0 = auto (by the number of CPU cores)
+    int hashing_threads = 0;
+
+    // large files are hashed directly from the memory-mapped windows instead of being read into buffers
+    bool hashing_mmap = true;
+
+    // the hashed files: no access time updates, the read data is dropped from the page cache
+    bool hashing_cache_friendly = false;
+
+    // the number of reads in flight per file via io_uring (Linux), 1 or less = off
+    int hashing_queue_depth = 0;
+
+    // the read size is tuned per device during the run (64 KiB - 16 MiB), instead of the fixed 1 MiB
+    bool hashing_adaptive_chunk = false;
+
+    // the files are scheduled per storage device: an HDD is read one file at a time,
+    // while the other devices are read in parallel
+    bool hashing_per_device = true;
+
+    // the files of a rotational disk are read in the order of their location on the disk
+    // (the first extent, or the inode number), instead of the tree order
+    bool hashing_layout_order = true;
+
+    // the progress of the db creation and verification is saved to a sidecar file
+    // (*.checkpoint) periodically, so the process can be resumed after a crash
+    bool hashing_checkpoints = true;
+
+    // the hash state at the end of the large files is saved, so a grown file is updated by reading
+    // only its appended part. Off by default: the previous contents are checked by their edges only
+    // (the head and the end), a change in the middle along with the growth would go unnoticed
+    bool hashing_resume_grown = false;
+
+    // QoS, the limits of the hashing load (background verification):
+    // the I/O priority class: 0 = default, 1 = best-effort with the level 0 (highest) - 7, 2 = idle (Linux)
+    int qos_io_class = 0;
+    int qos_io_level = 4;
+    // the read bandwidth cap in MiB/s and the max number of hashing threads, 0 = no limit
+    int qos_bandwidth = 0;
+    int qos_threads = 0;
+
     QByteArray m_geometryMainWindow;
     QByteArray m_headerStateFs;
     QByteArray m_headerStateDb;
@@ -68,11 +123,17 @@ private:
     static const QString s_key_isLongExt;
     static const QString s_key_saveVerifDate;
     static const QString s_key_dbFlagConst;
+    static const QString s_key_dbFlagSamples;
+    static const QString s_key_dbFlagBlocks;
     static const QString s_key_instantSaving;
     static const QString s_key_considerDateModified;
     static const QString s_key_detectMoved;
     static const QString s_key_allowPasteIntoDb;
     static const QString s_key_importSumsWhenItemAdding;
+    static const QString s_key_extraAlgorithms;
+    static const QString s_key_verifyFastestDigest;
+    static const QString s_key_verifyFullDays;
+    static const QString s_key_spotCheckPercent;
     static const QString s_key_history_lastFsPath;
     static const QString s_key_history_recentDbFiles;
     static const QString s_key_view_geometry;
@@ -86,6 +147,19 @@ private:
     static const QString s_key_filter_ignore_db;
     static const QString s_key_filter_ignore_unpermitted;
     static const QString s_key_filter_ignore_symlinks;
+    static const QString s_key_hashing_threads;
+    static const QString s_key_hashing_mmap;
+    static const QString s_key_hashing_cache_friendly;
+    static const QString s_key_hashing_queue_depth;
+    static const QString s_key_hashing_adaptive_chunk;
+    static const QString s_key_hashing_per_device;
+    static const QString s_key_hashing_layout_order;
+    static const QString s_key_hashing_checkpoints;
+    static const QString s_key_hashing_resume_grown;
+    static const QString s_key_qos_io_class;
+    static const QString s_key_qos_io_level;
+    static const QString s_key_qos_bandwidth;
+    static const QString s_key_qos_threads;
 
 signals:
     void algorithmChanged();
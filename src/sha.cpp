@@ -0,0 +1,312 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "sha.h"
+#include "sha_p.h"
+#include <cstring>
+
+using namespace sha;
+
+namespace {
+
+using CompressFunc = void (*)(uint32_t *state, const uint8_t *data, size_t blocks);
+
+// the hardware kernel of the 'variant', nullptr if there is none on this CPU
+CompressFunc kernel(Sha::Variant variant)
+{
+#ifdef VER_ARCH_X86
+    if (CpuFeatures::current().shaNi)
+        return (variant == Sha::Sha1) ? sha1CompressShaNi : sha256CompressShaNi;
+#endif
+
+#ifdef VER_ARCH_ARM64
+    if (CpuFeatures::current().armSha)
+        return (variant == Sha::Sha1) ? sha1CompressArmv8 : sha256CompressArmv8;
+#endif
+
+    (void)variant;
+    return nullptr;
+}
+
+using MultiCompressFunc = void (*)(uint32_t *state, const uint8_t *const *blocks);
+
+inline void storeBe32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+} // namespace
+
+Sha::Sha(Variant variant)
+    : m_variant(variant), m_compress(kernel(variant))
+{
+    reset();
+}
+
+void Sha::reset()
+{
+    if (m_variant == Sha1)
+        std::memcpy(m_state, k_sha1Iv, sizeof(k_sha1Iv));
+    else
+        std::memcpy(m_state, k_sha256Iv, sizeof(k_sha256Iv));
+
+    m_bufferLen = 0;
+    m_length = 0;
+}
+
+void Sha::update(const void *data, size_t length)
+{
+    if (!m_compress)
+        return;
+
+    const uint8_t *input = static_cast<const uint8_t*>(data);
+    m_length += length;
+
+    // completing the buffered block
+    if (m_bufferLen > 0) {
+        const size_t take = (length < k_blockLen - m_bufferLen) ? length : (k_blockLen - m_bufferLen);
+        std::memcpy(m_buffer + m_bufferLen, input, take);
+        m_bufferLen += take;
+        input += take;
+        length -= take;
+
+        if (m_bufferLen < k_blockLen)
+            return;
+
+        m_compress(m_state, m_buffer, 1);
+        m_bufferLen = 0;
+    }
+
+    // the full blocks straight from the input
+    const size_t blocks = length / k_blockLen;
+
+    if (blocks > 0) {
+        m_compress(m_state, input, blocks);
+        input += blocks * k_blockLen;
+        length -= blocks * k_blockLen;
+    }
+
+    std::memcpy(m_buffer, input, length);
+    m_bufferLen = length;
+}
+
+void Sha::finalize(uint8_t *out) const
+{
+    if (!m_compress)
+        return;
+
+    uint32_t state[8];
+    std::memcpy(state, m_state, sizeof(state));
+
+    // the padding: 0x80, zeros, the message length in bits (big-endian)
+    uint8_t tail[k_blockLen * 2] = {};
+    std::memcpy(tail, m_buffer, m_bufferLen);
+    tail[m_bufferLen] = 0x80;
+
+    const size_t tailLen = (m_bufferLen < k_blockLen - 8) ? k_blockLen : (k_blockLen * 2);
+    const uint64_t bits = m_length * 8;
+
+    for (size_t i = 0; i < 8; ++i)
+        tail[tailLen - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+
+    m_compress(state, tail, tailLen / k_blockLen);
+
+    for (size_t i = 0; i < digestLength() / 4; ++i)
+        storeBe32(out + i * 4, state[i]);
+}
+
+// the variant, the length (8 bytes), the state words, the buffered bytes; little-endian
+void Sha::saveState(std::vector<uint8_t> &out) const
+{
+    const size_t words = (m_variant == Sha1) ? 5 : 8;
+
+    out.clear();
+    out.push_back(m_variant);
+
+    for (size_t i = 0; i < 8; ++i)
+        out.push_back(static_cast<uint8_t>(m_length >> (i * 8)));
+
+    for (size_t w = 0; w < words; ++w) {
+        for (size_t i = 0; i < 4; ++i)
+            out.push_back(static_cast<uint8_t>(m_state[w] >> (i * 8)));
+    }
+
+    out.insert(out.end(), m_buffer, m_buffer + m_bufferLen);
+}
+
+bool Sha::loadState(const uint8_t *data, size_t length)
+{
+    const size_t words = (m_variant == Sha1) ? 5 : 8;
+    const size_t head = 1 + 8 + words * 4;
+
+    if (length < head || data[0] != m_variant)
+        return false;
+
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < 8; ++i)
+        total |= static_cast<uint64_t>(data[1 + i]) << (i * 8);
+
+    // the buffer holds the bytes beyond the last full block
+    const size_t bufferLen = static_cast<size_t>(total % k_blockLen);
+
+    if (length != head + bufferLen)
+        return false;
+
+    const uint8_t *p = data + 9;
+
+    for (size_t w = 0; w < words; ++w, p += 4) {
+        m_state[w] = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+                     | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    std::memcpy(m_buffer, p, bufferLen);
+    m_bufferLen = bufferLen;
+    m_length = total;
+
+    return true;
+}
+
+size_t Sha::digestLength() const
+{
+    return (m_variant == Sha1) ? 20 : 32;
+}
+
+bool Sha::isSupported(Variant variant)
+{
+    return kernel(variant) != nullptr;
+}
+
+const char* Sha::engineName()
+{
+#ifdef VER_ARCH_X86
+    if (CpuFeatures::current().shaNi)
+        return "SHA-NI";
+#endif
+
+#ifdef VER_ARCH_ARM64
+    if (CpuFeatures::current().armSha)
+        return "ARMv8 Crypto";
+#endif
+
+    return nullptr;
+}
+
+int Sha::multiLanes()
+{
+#ifdef VER_ARCH_X86
+    const CpuFeatures &cpu = CpuFeatures::current();
+
+    if (cpu.avx2)
+        return 8;
+    if (cpu.sse41)
+        return 4;
+#endif
+
+    return 0;
+}
+
+void Sha::sha256Multi(const uint8_t *const *data, const size_t *lengths, size_t count, uint8_t *digests)
+{
+    static constexpr size_t k_maxLanes = 8;
+    static constexpr size_t k_none = SIZE_MAX;
+    static const uint8_t s_idle[k_blockLen] = {}; // the block of a lane with no message left
+
+    const size_t lanes = static_cast<size_t>(multiLanes());
+    MultiCompressFunc compress = nullptr;
+
+#ifdef VER_ARCH_X86
+    compress = (lanes == 8) ? sha256CompressX8Avx2 : sha256CompressX4Sse41;
+#endif
+
+    if (lanes == 0 || !compress)
+        return;
+
+    struct Lane {
+        size_t message = k_none;
+        size_t block = 0;       // the next one
+        size_t fullBlocks = 0;  // taken from the message itself
+        size_t blocks = 0;      // + the padded tail
+        uint8_t tail[k_blockLen * 2];
+    };
+
+    Lane lane[k_maxLanes];
+    alignas(64) uint32_t state[8 * k_maxLanes];
+    const uint8_t *blocks[k_maxLanes];
+    size_t next = 0;
+
+    // the lane takes the next message; false if there are none left
+    auto take = [&](size_t ln) -> bool {
+        Lane &cur = lane[ln];
+
+        if (next >= count) {
+            cur.message = k_none;
+            return false;
+        }
+
+        cur.message = next++;
+        cur.block = 0;
+
+        const size_t length = lengths[cur.message];
+        const size_t rest = length % k_blockLen;
+        cur.fullBlocks = length / k_blockLen;
+
+        std::memset(cur.tail, 0, sizeof(cur.tail));
+        if (rest > 0)
+            std::memcpy(cur.tail, data[cur.message] + cur.fullBlocks * k_blockLen, rest);
+        cur.tail[rest] = 0x80;
+
+        const size_t tailLen = (rest < k_blockLen - 8) ? k_blockLen : (k_blockLen * 2);
+        const uint64_t bits = static_cast<uint64_t>(length) * 8;
+
+        for (size_t i = 0; i < 8; ++i)
+            cur.tail[tailLen - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+
+        cur.blocks = cur.fullBlocks + tailLen / k_blockLen;
+
+        for (size_t i = 0; i < 8; ++i)
+            state[i * lanes + ln] = k_sha256Iv[i];
+
+        return true;
+    };
+
+    size_t active = 0;
+    for (size_t ln = 0; ln < lanes; ++ln) {
+        if (take(ln))
+            ++active;
+    }
+
+    while (active > 0) {
+        for (size_t ln = 0; ln < lanes; ++ln) {
+            const Lane &cur = lane[ln];
+
+            if (cur.message == k_none)
+                blocks[ln] = s_idle;
+            else if (cur.block < cur.fullBlocks)
+                blocks[ln] = data[cur.message] + cur.block * k_blockLen;
+            else
+                blocks[ln] = cur.tail + (cur.block - cur.fullBlocks) * k_blockLen;
+        }
+
+        compress(state, blocks);
+
+        for (size_t ln = 0; ln < lanes; ++ln) {
+            Lane &cur = lane[ln];
+
+            if (cur.message == k_none || ++cur.block < cur.blocks)
+                continue;
+
+            uint8_t *out = digests + cur.message * 32;
+            for (size_t i = 0; i < 8; ++i)
+                storeBe32(out + i * 4, state[i * lanes + ln]);
+
+            if (!take(ln))
+                --active;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef SHA_H
+#define SHA_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/* SHA-1 and SHA-256 by the hardware instructions of the CPU:
+ * the x86 SHA extensions (SHA-NI) or the ARMv8 Cryptography Extensions.
+ * The kernels are selected at runtime by the CPU features (::isSupported);
+ * if there are none, the hashing is left to QCryptographicHash (see HashFunction).
+ */
+class Sha
+{
+public:
+    enum Variant : uint8_t { Sha1, Sha256 };
+
+    explicit Sha(Variant variant);
+
+    void reset();
+    void update(const void *data, size_t length);
+
+    // writes the digest (::digestLength bytes), the state is not changed
+    void finalize(uint8_t *out) const;
+
+    size_t digestLength() const;
+
+    // the intermediate state to continue the hashing from later (e.g. a grown file); the same on all CPUs
+    void saveState(std::vector<uint8_t> &out) const;
+
+    // returns false if the 'data' is not a saved state of the same variant, the current one is kept then
+    bool loadState(const uint8_t *data, size_t length);
+
+    // there is a hardware kernel for the 'variant' on this CPU
+    static bool isSupported(Variant variant);
+
+    // "SHA-NI", "ARMv8 Crypto", or nullptr if not supported
+    static const char* engineName();
+
+    // the lanes of the multi-buffer SHA-256 on this CPU: 8 (AVX2), 4 (SSE4.1), or 0 if none
+    static int multiLanes();
+
+    /* The SHA-256 digests of the 'count' independent messages (32 bytes each, written to the 'digests'),
+     * several messages hashed at once by the SIMD lanes: a lane takes the next message as soon as
+     * it is done with the previous one. The ::multiLanes() must be > 0.
+     */
+    static void sha256Multi(const uint8_t *const *data, const size_t *lengths, size_t count, uint8_t *digests);
+
+    static constexpr size_t k_blockLen = 64;
+
+private:
+    // compresses the 'blocks' full blocks of the 'data' into the 'state'
+    using Compress = void (*)(uint32_t *state, const uint8_t *data, size_t blocks);
+
+    const Variant m_variant;
+    Compress m_compress = nullptr;
+    uint32_t m_state[8];
+    uint8_t m_buffer[k_blockLen];
+    size_t m_bufferLen = 0;
+    uint64_t m_length = 0; // bytes
+}; // class Sha
+
+#endif // SHA_H
@@ -0,0 +1,117 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "sha_p.h"
+
+#ifdef VER_ARCH_ARM64
+#include <arm_neon.h>
+#include <utility>
+
+namespace sha {
+namespace {
+// the big-endian words of the message
+inline uint32x4_t loadBe(const uint8_t *p)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+/* The 4 rounds of SHA-1 (of the group 'G' of 20) with the function G / 5: Ch, Parity, Maj, Parity.
+ * The message words of the group are computed from the previous 4 groups (sha1su0, sha1su1).
+ * The groups are unrolled (std::integer_sequence), so the words stay in the registers.
+ */
+template <int G>
+inline void sha1Rounds(uint32x4_t &abcd, uint32_t &e, uint32x4_t msg[4])
+{
+    if (G >= 4)
+        msg[G & 3] = vsha1su1q_u32(vsha1su0q_u32(msg[G & 3], msg[(G - 3) & 3], msg[(G - 2) & 3]), msg[(G - 1) & 3]);
+
+    const uint32x4_t wk = vaddq_u32(msg[G & 3], vdupq_n_u32(k_sha1K[G / 5]));
+    const uint32_t eNext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+    if (G < 5)
+        abcd = vsha1cq_u32(abcd, e, wk);
+    else if (G >= 10 && G < 15)
+        abcd = vsha1mq_u32(abcd, e, wk);
+    else
+        abcd = vsha1pq_u32(abcd, e, wk);
+
+    e = eNext;
+}
+
+template <int... G>
+inline void sha1Block(std::integer_sequence<int, G...>, uint32x4_t &abcd, uint32_t &e, uint32x4_t msg[4])
+{
+    (sha1Rounds<G>(abcd, e, msg), ...);
+}
+
+// the 4 rounds of SHA-256 (of the group 'G' of 16), the message words of the next groups computed in turn
+template <int G>
+inline void sha256Rounds(uint32x4_t &abcd, uint32x4_t &efgh, uint32x4_t msg[4])
+{
+    if (G >= 4)
+        msg[G & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[G & 3], msg[(G - 3) & 3]), msg[(G - 2) & 3], msg[(G - 1) & 3]);
+
+    const uint32x4_t wk = vaddq_u32(msg[G & 3], vld1q_u32(k_sha256K + G * 4));
+    const uint32x4_t abcdPrev = abcd;
+
+    abcd = vsha256hq_u32(abcd, efgh, wk);
+    efgh = vsha256h2q_u32(efgh, abcdPrev, wk);
+}
+
+template <int... G>
+inline void sha256Block(std::integer_sequence<int, G...>, uint32x4_t &abcd, uint32x4_t &efgh, uint32x4_t msg[4])
+{
+    (sha256Rounds<G>(abcd, efgh, msg), ...);
+}
+} // namespace
+
+void sha1CompressArmv8(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const uint32x4_t abcdSave = abcd;
+        const uint32_t eSave = e;
+
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = loadBe(data + i * 16);
+
+        sha1Block(std::make_integer_sequence<int, 20>(), abcd, e, msg);
+
+        abcd = vaddq_u32(abcd, abcdSave);
+        e += eSave;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+void sha256CompressArmv8(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const uint32x4_t abcdSave = abcd;
+        const uint32x4_t efghSave = efgh;
+
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = loadBe(data + i * 16);
+
+        sha256Block(std::make_integer_sequence<int, 16>(), abcd, efgh, msg);
+
+        abcd = vaddq_u32(abcd, abcdSave);
+        efgh = vaddq_u32(efgh, efghSave);
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+} // namespace sha
+
+#endif // VER_ARCH_ARM64
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "sha_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+
+namespace sha {
+namespace {
+struct V256 {
+    using T = __m256i;
+    static constexpr size_t lanes = 8;
+
+    static T set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static T add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm256_xor_si256(a, b); }
+    static T and_(T a, T b) { return _mm256_and_si256(a, b); }
+    static T or_(T a, T b) { return _mm256_or_si256(a, b); }
+    template <int N> static T shr(T x) { return _mm256_srli_epi32(x, N); }
+    template <int N> static T rotr(T x) { return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N)); }
+    static T load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t *p, T x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+}; // struct V256
+} // namespace
+
+void sha256CompressX8Avx2(uint32_t *state, const uint8_t *const *blocks)
+{
+    sha256CompressLanes<V256>(state, blocks);
+}
+} // namespace sha
+
+#endif // VER_ARCH_X86
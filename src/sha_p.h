@@ -0,0 +1,148 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef SHA_P_H
+#define SHA_P_H
+
+/* SHA internals shared by the common code (sha.cpp), the hardware kernels (sha_shani.cpp, sha_armv8.cpp)
+ * and the multi-buffer SHA-256 kernels (sha_sse41.cpp, sha_avx2.cpp).
+ * Each kernel file is compiled with its own instruction set flags.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include "cpufeatures.h"
+
+namespace sha {
+
+static constexpr uint32_t k_sha1Iv[5] = {
+    0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+static constexpr uint32_t k_sha256Iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static constexpr uint32_t k_sha1K[4] = {
+    0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6
+};
+
+static constexpr uint32_t k_sha256K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/* Each kernel compresses the 'blocks' full 64-byte blocks of the 'data' into the 'state'
+ * (5 words of SHA-1 or 8 words of SHA-256, in the standard order).
+ */
+#ifdef VER_ARCH_X86
+void sha1CompressShaNi(uint32_t *state, const uint8_t *data, size_t blocks);
+void sha256CompressShaNi(uint32_t *state, const uint8_t *data, size_t blocks);
+#endif
+
+#ifdef VER_ARCH_ARM64
+void sha1CompressArmv8(uint32_t *state, const uint8_t *data, size_t blocks);
+void sha256CompressArmv8(uint32_t *state, const uint8_t *data, size_t blocks);
+#endif
+
+/* The multi-buffer SHA-256: a 64-byte block of each of the 'lanes' independent messages
+ * ('blocks', one pointer per lane) is compressed at once.
+ * The 'state' holds 8 words of each lane, the same word of all lanes in a row: state[word * lanes + lane].
+ */
+#ifdef VER_ARCH_X86
+void sha256CompressX4Sse41(uint32_t *state, const uint8_t *const *blocks); // 4 lanes
+void sha256CompressX8Avx2(uint32_t *state, const uint8_t *const *blocks);  // 8 lanes
+#endif
+
+namespace {
+inline uint32_t loadBe32(const uint8_t *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+           | (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/* The vectorized SHA-256 round 'R' of 64. 'V' provides the operations on a vector of 'V::lanes' words:
+ * set1, add, xor_, and_, or_, shr<N>, rotr<N> (rotate right), load, store.
+ * The working variables are not moved: the slot of 'a' goes back by one each round.
+ */
+template <typename V, int R>
+inline void sha256Round(typename V::T s[8], typename V::T w[16])
+{
+    using T = typename V::T;
+
+    if (R >= 16) {
+        const T w15 = w[(R - 15) & 15];
+        const T w2 = w[(R - 2) & 15];
+        const T s0 = V::xor_(V::xor_(V::template rotr<7>(w15), V::template rotr<18>(w15)), V::template shr<3>(w15));
+        const T s1 = V::xor_(V::xor_(V::template rotr<17>(w2), V::template rotr<19>(w2)), V::template shr<10>(w2));
+        w[R & 15] = V::add(V::add(w[R & 15], s0), V::add(w[(R - 7) & 15], s1));
+    }
+
+    const T a = s[(0 - R) & 7];
+    const T b = s[(1 - R) & 7];
+    const T c = s[(2 - R) & 7];
+    T &d = s[(3 - R) & 7];
+    const T e = s[(4 - R) & 7];
+    const T f = s[(5 - R) & 7];
+    const T g = s[(6 - R) & 7];
+    T &h = s[(7 - R) & 7];
+
+    const T sum1 = V::xor_(V::xor_(V::template rotr<6>(e), V::template rotr<11>(e)), V::template rotr<25>(e));
+    const T ch = V::xor_(g, V::and_(e, V::xor_(f, g)));
+    const T t1 = V::add(V::add(V::add(h, sum1), V::add(ch, V::set1(k_sha256K[R]))), w[R & 15]);
+
+    const T sum0 = V::xor_(V::xor_(V::template rotr<2>(a), V::template rotr<13>(a)), V::template rotr<22>(a));
+    const T maj = V::or_(V::and_(a, b), V::and_(c, V::or_(a, b)));
+
+    d = V::add(d, t1);
+    h = V::add(t1, V::add(sum0, maj)); // the next 'a'
+}
+
+template <typename V, int... R>
+inline void sha256Rounds(std::integer_sequence<int, R...>, typename V::T s[8], typename V::T w[16])
+{
+    (sha256Round<V, R>(s, w), ...);
+}
+
+template <typename V>
+inline void sha256CompressLanes(uint32_t *state, const uint8_t *const *blocks)
+{
+    using T = typename V::T;
+
+    // transposing: the same message word of all lanes in a row
+    alignas(64) uint32_t words[16 * V::lanes];
+
+    for (size_t lane = 0; lane < V::lanes; ++lane) {
+        for (size_t i = 0; i < 16; ++i)
+            words[i * V::lanes + lane] = loadBe32(blocks[lane] + i * 4);
+    }
+
+    T w[16];
+    for (size_t i = 0; i < 16; ++i)
+        w[i] = V::load(words + i * V::lanes);
+
+    T s[8];
+    T saved[8];
+    for (size_t i = 0; i < 8; ++i)
+        s[i] = saved[i] = V::load(state + i * V::lanes);
+
+    sha256Rounds<V>(std::make_integer_sequence<int, 64>(), s, w);
+
+    for (size_t i = 0; i < 8; ++i)
+        V::store(state + i * V::lanes, V::add(s[i], saved[i]));
+}
+} // namespace
+
+} // namespace sha
+
+#endif // SHA_P_H
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "sha_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+#include <utility>
+
+namespace sha {
+namespace {
+inline __m128i loadu(const uint8_t *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+/* The 4 rounds of SHA-1 (of the group 'G' of 20) with the function G / 5,
+ * and the schedule of the next message words: each group of 4 is completed by sha1msg2
+ * one group ahead of its use, after sha1msg1 and the xor of the previous two groups.
+ * The groups are unrolled (std::integer_sequence), so the words stay in the registers.
+ */
+template <int G>
+inline void sha1Rounds(__m128i &abcd, __m128i e[2], __m128i msg[4])
+{
+    constexpr int cur = G & 1;
+
+    e[cur] = (G == 0) ? _mm_add_epi32(e[cur], msg[0]) : _mm_sha1nexte_epu32(e[cur], msg[G & 3]);
+    e[cur ^ 1] = abcd;
+
+    if (G >= 3 && G <= 18)
+        msg[(G + 1) & 3] = _mm_sha1msg2_epu32(msg[(G + 1) & 3], msg[G & 3]);
+
+    abcd = _mm_sha1rnds4_epu32(abcd, e[cur], G / 5);
+
+    if (G >= 1 && G <= 16)
+        msg[(G + 3) & 3] = _mm_sha1msg1_epu32(msg[(G + 3) & 3], msg[G & 3]);
+
+    if (G >= 2 && G <= 17)
+        msg[(G + 2) & 3] = _mm_xor_si128(msg[(G + 2) & 3], msg[G & 3]);
+}
+
+template <int... G>
+inline void sha1Block(std::integer_sequence<int, G...>, __m128i &abcd, __m128i e[2], __m128i msg[4])
+{
+    (sha1Rounds<G>(abcd, e, msg), ...);
+}
+
+// the 4 rounds of SHA-256 (of the group 'G' of 16), the message words of the next groups computed in turn
+template <int G>
+inline void sha256Rounds(__m128i &state0, __m128i &state1, __m128i msg[4])
+{
+    if (G >= 4) {
+        // W[t-16] + s0(W[t-15]) + W[t-7] + s1(W[t-2])
+        const __m128i tmp = _mm_add_epi32(_mm_sha256msg1_epu32(msg[G & 3], msg[(G - 3) & 3]),
+                                          _mm_alignr_epi8(msg[(G - 1) & 3], msg[(G - 2) & 3], 4));
+        msg[G & 3] = _mm_sha256msg2_epu32(tmp, msg[(G - 1) & 3]);
+    }
+
+    __m128i wk = _mm_add_epi32(msg[G & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(k_sha256K + G * 4)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+    wk = _mm_shuffle_epi32(wk, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+}
+
+template <int... G>
+inline void sha256Block(std::integer_sequence<int, G...>, __m128i &state0, __m128i &state1, __m128i msg[4])
+{
+    (sha256Rounds<G>(state0, state1, msg), ...);
+}
+} // namespace
+
+void sha1CompressShaNi(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+    // the words are reversed: A is the highest one
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+
+    __m128i abcd = _mm_shuffle_epi32(loadu(reinterpret_cast<const uint8_t*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abcdSave = abcd;
+        const __m128i e0Save = e0;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = _mm_shuffle_epi8(loadu(data + i * 16), mask);
+
+        __m128i e[2] = { e0, e0 };
+        sha1Block(std::make_integer_sequence<int, 20>(), abcd, e, msg);
+
+        // the last group used e[1], e[0] holds the state before it
+        e0 = _mm_sha1nexte_epu32(e[0], e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+void sha256CompressShaNi(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+    // the bytes of each word are reversed
+    const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // the state as ABEF and CDGH, the order of the sha256rnds2
+    __m128i tmp = _mm_shuffle_epi32(loadu(reinterpret_cast<const uint8_t*>(state)), 0xB1);      // CDAB
+    __m128i state1 = _mm_shuffle_epi32(loadu(reinterpret_cast<const uint8_t*>(state + 4)), 0x1B); // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);         // CDGH
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abefSave = state0;
+        const __m128i cdghSave = state1;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = _mm_shuffle_epi8(loadu(data + i * 16), mask);
+
+        sha256Block(std::make_integer_sequence<int, 16>(), state0, state1, msg);
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);               // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);            // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);         // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);            // HGFE
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+} // namespace sha
+
+#endif // VER_ARCH_X86
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "sha_p.h"
+
+#ifdef VER_ARCH_X86
+#include <immintrin.h>
+
+namespace sha {
+namespace {
+struct V128 {
+    using T = __m128i;
+    static constexpr size_t lanes = 4;
+
+    static T set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static T add(T a, T b) { return _mm_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm_xor_si128(a, b); }
+    static T and_(T a, T b) { return _mm_and_si128(a, b); }
+    static T or_(T a, T b) { return _mm_or_si128(a, b); }
+    template <int N> static T shr(T x) { return _mm_srli_epi32(x, N); }
+    template <int N> static T rotr(T x) { return _mm_or_si128(_mm_srli_epi32(x, N), _mm_slli_epi32(x, 32 - N)); }
+    static T load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t *p, T x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+}; // struct V128
+} // namespace
+
+void sha256CompressX4Sse41(uint32_t *state, const uint8_t *const *blocks)
+{
+    sha256CompressLanes<V128>(state, blocks);
+}
+} // namespace sha
+
+#endif // VER_ARCH_X86
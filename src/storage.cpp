@@ -0,0 +1,303 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "storage.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sys/sysmacros.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
+#endif
+
+namespace storage {
+
+quint64 deviceId(const QString &path)
+{
+#if defined(Q_OS_UNIX)
+    struct stat st;
+
+    if (::stat(QFile::encodeName(path).constData(), &st) == 0)
+        return static_cast<quint64>(st.st_dev);
+#else
+    Q_UNUSED(path)
+#endif
+
+    return 0;
+}
+
+quint64 deviceId(int fd)
+{
+#if defined(Q_OS_UNIX)
+    struct stat st;
+
+    if (fd >= 0 && ::fstat(fd, &st) == 0)
+        return static_cast<quint64>(st.st_dev);
+#else
+    Q_UNUSED(fd)
+#endif
+
+    return 0;
+}
+
+#if defined(Q_OS_LINUX)
+// 'blockDir' is the /sys/block/<dev> (or partition) folder
+static bool isRotationalBlockDir(const QString &blockDir, int depth)
+{
+    QString queueDir = blockDir + QStringLiteral(u"/queue");
+
+    // a partition: the queue belongs to the whole disk
+    if (!QFileInfo::exists(queueDir))
+        queueDir = QFileInfo(blockDir).path() + QStringLiteral(u"/queue");
+
+    QFile rotational(queueDir + QStringLiteral(u"/rotational"));
+
+    if (rotational.open(QFile::ReadOnly) && rotational.readAll().trimmed() == "1")
+        return true;
+
+    // device-mapper, md: the backing devices
+    if (depth < 4) {
+        const QDir slaves(blockDir + QStringLiteral(u"/slaves"));
+        const QFileInfoList entries = slaves.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+        for (const QFileInfo &fi : entries) {
+            if (isRotationalBlockDir(fi.canonicalFilePath(), depth + 1))
+                return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+bool isRotational(quint64 device)
+{
+#if defined(Q_OS_LINUX)
+    if (major(device) == 0) // not a block device
+        return false;
+
+    const QString sysDev = QStringLiteral(u"/sys/dev/block/") + deviceName(device);
+    const QString blockDir = QFileInfo(sysDev).canonicalFilePath();
+
+    return !blockDir.isEmpty() && isRotationalBlockDir(blockDir, 0);
+#else
+    Q_UNUSED(device)
+    return false;
+#endif
+}
+
+int preferredStreams(quint64 device)
+{
+    return isRotational(device) ? 1 : 0;
+}
+
+QString deviceName(quint64 device)
+{
+#if defined(Q_OS_LINUX)
+    return QString::number(major(device)) + ':' + QString::number(minor(device));
+#else
+    return QString::number(device, 16);
+#endif
+}
+
+qint64 physicalOffset(const QString &path)
+{
+#if defined(Q_OS_LINUX)
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return -1;
+
+    // a single extent is enough: the first one
+    alignas(struct fiemap) char buf[sizeof(struct fiemap) + sizeof(struct fiemap_extent)] = {};
+    struct fiemap *map = reinterpret_cast<struct fiemap*>(buf);
+    map->fm_start = 0;
+    map->fm_length = FIEMAP_MAX_OFFSET;
+    map->fm_extent_count = 1;
+
+    const int res = ::ioctl(fd, FS_IOC_FIEMAP, map);
+    ::close(fd);
+
+    if (res < 0)
+        return -1;
+
+    return (map->fm_mapped_extents > 0) ? static_cast<qint64>(map->fm_extents[0].fe_physical) : 0;
+#else
+    Q_UNUSED(path)
+    return -1;
+#endif
+}
+
+quint64 inode(const QString &path)
+{
+#if defined(Q_OS_UNIX)
+    struct stat st;
+
+    if (::stat(QFile::encodeName(path).constData(), &st) == 0)
+        return static_cast<quint64>(st.st_ino);
+#else
+    Q_UNUSED(path)
+#endif
+
+    return 0;
+}
+
+QList<QPair<qint64, qint64>> holes(int fd, qint64 minLength)
+{
+    QList<QPair<qint64, qint64>> res;
+
+#if defined(Q_OS_UNIX) && defined(SEEK_HOLE) && defined(SEEK_DATA)
+    struct stat st;
+
+    // all the blocks are allocated: no holes, no seeking
+    if (fd < 0 || ::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)
+        || static_cast<qint64>(st.st_blocks) * 512 >= static_cast<qint64>(st.st_size))
+    {
+        return res;
+    }
+
+    const qint64 size = static_cast<qint64>(st.st_size);
+    qint64 pos = 0;
+
+    while (pos < size) {
+        // the end of the file is an implicit hole; -1: not supported by the file system
+        const qint64 holeStart = static_cast<qint64>(::lseek(fd, pos, SEEK_HOLE));
+
+        if (holeStart < 0 || holeStart >= size)
+            break;
+
+        qint64 holeEnd = static_cast<qint64>(::lseek(fd, holeStart, SEEK_DATA));
+
+        // ENXIO: no more data, the hole lasts to the end; any other error: the rest is read as usual
+        if (holeEnd < 0) {
+            if (errno != ENXIO)
+                break;
+
+            holeEnd = size;
+        }
+        else if (holeEnd > size) {
+            holeEnd = size;
+        }
+
+        if (holeEnd - holeStart >= minLength)
+            res.append({ holeStart, holeEnd - holeStart });
+
+        pos = holeEnd;
+    }
+
+    // the reading position is not left moved
+    ::lseek(fd, 0, SEEK_SET);
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(minLength)
+#endif
+
+    return res;
+}
+
+QString fingerprint(const QString &path, QPair<quint64, quint64> *linkId)
+{
+    qint64 size = -1;
+    qint64 mtime = 0;
+    quint64 ino = 0;
+
+    if (linkId)
+        *linkId = { 0, 0 };
+
+#if defined(Q_OS_UNIX)
+    struct stat st;
+
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISREG(st.st_mode))
+        return QString();
+
+    size = static_cast<qint64>(st.st_size);
+    ino = static_cast<quint64>(st.st_ino);
+#if defined(Q_OS_DARWIN)
+    mtime = static_cast<qint64>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+
+    if (linkId && st.st_nlink > 1)
+        *linkId = { static_cast<quint64>(st.st_dev), ino };
+#else
+    const QFileInfo fi(path);
+
+    if (!fi.isFile())
+        return QString();
+
+    size = fi.size();
+    mtime = fi.lastModified().toMSecsSinceEpoch() * 1000000;
+#endif
+
+    // as a string: the nanoseconds do not fit the precision of a json number (double)
+    return QString::number(size) + ':' + QString::number(mtime) + ':' + QString::number(ino);
+}
+
+qint64 fingerprintSize(const QString &fingerprint)
+{
+    bool ok = false;
+    const qint64 size = fingerprint.section(':', 0, 0).toLongLong(&ok);
+
+    return ok ? size : -1;
+}
+
+QList<int> layoutOrder(const QStringList &paths)
+{
+    QList<int> order(paths.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    if (paths.size() < 2)
+        return order;
+
+    std::vector<quint64> keys(paths.size(), 0);
+    bool isPhysical = true;
+    bool isSupported = false;
+
+    for (int i = 0; i < paths.size(); ++i) {
+        if (isPhysical) {
+            const qint64 offset = physicalOffset(paths.at(i));
+
+            if (offset >= 0) {
+                keys[i] = offset;
+                isSupported = true;
+                continue;
+            }
+
+            // the file system does not report the extents (or the file is gone):
+            // the inode numbers of all files then, the mix of both is useless
+            if (isSupported)
+                continue;
+
+            isPhysical = false;
+        }
+
+        keys[i] = inode(paths.at(i));
+        isSupported = isSupported || (keys[i] > 0);
+    }
+
+    if (isSupported) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&keys](int a, int b){ return keys[a] < keys[b]; });
+    }
+
+    return order;
+}
+
+} // namespace storage
@@ -0,0 +1,63 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+
+/* The devices the files reside on, to schedule the reading per device:
+ * a spinning disk is read by a single stream (no seeking between files),
+ * the others by as many as there are hashing threads.
+ * Where the OS is not supported, all files are on the device 0 and it is not rotational.
+ */
+namespace storage {
+
+// the device of the file or folder (st_dev), 0 if not supported
+quint64 deviceId(const QString &path);
+quint64 deviceId(int fd);
+
+// Linux: the block device is rotational (HDD); for the device-mapper and md devices,
+// any of the underlying ones is. No block device (network, tmpfs, etc.): false
+bool isRotational(quint64 device);
+
+// the number of files read from the device at once, 0 = no limit
+int preferredStreams(quint64 device);
+
+// "8:16" (major:minor)
+QString deviceName(quint64 device);
+
+// the position of the file data on the device: the physical offset of the first extent (Linux FIEMAP);
+// 0 for a file without data extents, -1 if not supported
+qint64 physicalOffset(const QString &path);
+
+// the inode number of the file, 0 if not supported
+quint64 inode(const QString &path);
+
+// the holes of a sparse file: the {offset, length} ranges that read as zeros without being stored,
+// ascending; only the ones of 'minLength' or more. Empty if the file has no holes or it is not supported
+QList<QPair<qint64, qint64>> holes(int fd, qint64 minLength);
+
+// the state of the file to tell if it has changed since: "size:mtime:inode",
+// the modification time in nanoseconds (milliseconds * 10^6 where not supported);
+// empty if the file can't be stat'ed;
+// 'linkId' (if not nullptr) is set by the same stat: the identity of a file that has several hard links,
+// {st_dev, st_ino}, the same for all its paths; {0, 0} if the file has a single link or it is not supported
+QString fingerprint(const QString &path, QPair<quint64, quint64> *linkId = nullptr);
+
+// the file size of the fingerprint, -1 if it is not valid
+qint64 fingerprintSize(const QString &fingerprint);
+
+// the order of reading the 'paths' (of the same device) with fewer seeks: the indexes of the 'paths'
+// sorted by the physical offsets, by the inode numbers if the file system does not report the extents;
+// the original order if neither is supported
+QList<int> layoutOrder(const QStringList &paths);
+
+} // namespace storage
+
+#endif // STORAGE_H
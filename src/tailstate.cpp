@@ -0,0 +1,65 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "tailstate.h"
+#include <QStringList>
+
+TailState::TailState(qint64 fileSize, const QString &digest, const QString &edgeDigest, const QByteArray &state)
+    : m_fileSize(fileSize), m_digest(digest), m_edgeDigest(edgeDigest), m_state(state)
+{}
+
+TailState TailState::fromString(const QString &str)
+{
+    const QStringList parts = str.split(':');
+
+    if (parts.size() != 4)
+        return TailState();
+
+    bool ok = false;
+    const qint64 fileSize = parts.at(0).toLongLong(&ok);
+
+    if (!ok)
+        return TailState();
+
+    const TailState res(fileSize, parts.at(1), parts.at(2), QByteArray::fromBase64(parts.at(3).toLatin1()));
+    return res.isValid() ? res : TailState();
+}
+
+QString TailState::toString() const
+{
+    if (!isValid())
+        return QString();
+
+    return QString::number(m_fileSize) + ':' + m_digest + ':' + m_edgeDigest + ':'
+           + QString::fromLatin1(m_state.toBase64());
+}
+
+bool TailState::isValid() const
+{
+    return m_fileSize > 0
+           && !m_digest.isEmpty()
+           && !m_edgeDigest.isEmpty()
+           && !m_state.isEmpty();
+}
+
+qint64 TailState::fileSize() const
+{
+    return m_fileSize;
+}
+
+const QString& TailState::digest() const
+{
+    return m_digest;
+}
+
+const QString& TailState::edgeDigest() const
+{
+    return m_edgeDigest;
+}
+
+const QByteArray& TailState::state() const
+{
+    return m_state;
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef TAILSTATE_H
+#define TAILSTATE_H
+
+#include <QByteArray>
+#include <QString>
+
+/* The hash state of a large file at its end (of the main algorithm, HashFunction::state),
+ * stored along with the checksum: a file that has only grown since (logs, archives, recordings)
+ * is updated by hashing the appended part alone.
+ * The state belongs to the file contents of its ::digest, so it is valid only as long as that is the checksum.
+ * Before resuming, the unchanged prefix is confirmed by the digest of its edges (Hasher::calculateTail).
+ * The string form (db file): "<file size>:<hex digest>:<hex edge digest>:<base64 state>".
+ */
+class TailState
+{
+public:
+    TailState() = default;
+    TailState(qint64 fileSize, const QString &digest, const QString &edgeDigest, const QByteArray &state);
+
+    // an invalid state if the string is not one
+    static TailState fromString(const QString &str);
+    QString toString() const;
+
+    bool isValid() const;
+
+    // the number of bytes hashed
+    qint64 fileSize() const;
+
+    // the hex digest of the file
+    const QString& digest() const;
+
+    // the hex digest of the head and the end of the file (Hasher::calculateTail)
+    const QString& edgeDigest() const;
+
+    const QByteArray& state() const;
+
+private:
+    qint64 m_fileSize = 0;
+    QString m_digest;
+    QString m_edgeDigest;
+    QByteArray m_state;
+}; // class TailState
+
+#endif // TAILSTATE_H
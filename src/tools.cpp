@@ -146,11 +146,28 @@ FileStatus failedCalcStatus(const QString &path, bool isChecksumStored)
     return isChecksumStored ? FileStatus::Missing : FileStatus::Removed;
 }
 
+FileStatus failedCalcStatus(int errorCode, bool isChecksumStored)
+{
+    switch (errorCode) {
+    case ERR_READ:
+        return FileStatus::ReadError;
+    case ERR_NOPERM:
+        return FileStatus::UnPermitted;
+    case ERR_NOTEXIST:
+        return isChecksumStored ? FileStatus::Missing : FileStatus::Removed;
+    default:
+        return FileStatus::NotSet;
+    }
+}
+
 void openFile(QFile &file, QFile::OpenMode mode)
 {
     if (file.open(mode))
         return;
 
+    // the buffering mode does not matter here
+    mode.setFlag(QFile::Unbuffered, false);
+
     if (mode == QFile::ReadOnly) {
         if (!file.exists())
             throw Exception(ERR_NOTEXIST, "File not found.");
@@ -426,6 +443,8 @@ QString fileItemStatus(FileStatus status)
     case FileStatus::MovedOut: return QStringLiteral(u"moved out");
     case FileStatus::UnPermitted: return QStringLiteral(u"no permissions");
     case FileStatus::ReadError: return QStringLiteral(u"read error");
+    case FileStatus::SampleMatched: return QStringLiteral(u"sample match");
+    case FileStatus::Unchanged: return QStringLiteral(u"unchanged");
     default: return "unknown";
     }
 }
@@ -71,6 +71,9 @@ QString extractDigestFromFile(const QString &digest_file);
 
 FileStatus failedCalcStatus(const QString &path, bool isChecksumStored = false);
 
+// ERR_READ --> FileStatus::ReadError, ERR_NOPERM --> UnPermitted, ERR_NOTEXIST --> Missing/Removed
+FileStatus failedCalcStatus(int errorCode, bool isChecksumStored);
+
 // try to open the 'file'; if an error occurs, throws exceptions
 void openFile(QFile &file, QFile::OpenMode mode = QFile::ReadOnly);
 
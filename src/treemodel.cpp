@@ -8,6 +8,9 @@
 #include "tools.h"
 #include "pathstr.h"
 #include "iconprovider.h"
+#include "algostring.h"
+#include "blocklist.h"
+#include "tailstate.h"
 #include <QDebug>
 
 const QVector<QVariant> TreeModel::s_rootItemData = {
@@ -17,7 +20,13 @@ const QVector<QVariant> TreeModel::s_rootItemData = {
     QStringLiteral(u"Checksum"),
     QStringLiteral(u"ReChecksum"),
     QStringLiteral(u"Elapsed"),
-    QStringLiteral(u"Speed")
+    QStringLiteral(u"Speed"),
+    QStringLiteral(u"Extra Checksums"),
+    QStringLiteral(u"Sample Checksum"),
+    QStringLiteral(u"Fingerprint"),
+    QStringLiteral(u"Block Checksums"),
+    QStringLiteral(u"Changed Blocks"),
+    QStringLiteral(u"Tail State")
 };
 
 TreeModel::TreeModel(QObject *parent)
@@ -70,6 +79,21 @@ void TreeModel::add_file(const QString &filePath, const FileValues &values)
     if (!values.checksum.isEmpty())
         tiData[ColumnChecksum] = values.checksum;
 
+    if (!values.extraChecksums.isEmpty())
+        tiData[ColumnExtraChecksums] = extraChecksumsValue(values.extraChecksums);
+
+    if (!values.sampleChecksum.isEmpty())
+        tiData[ColumnSampleChecksum] = values.sampleChecksum;
+
+    if (!values.fingerprint.isEmpty())
+        tiData[ColumnFingerprint] = values.fingerprint;
+
+    if (!values.blockChecksums.isEmpty())
+        tiData[ColumnBlockChecksums] = values.blockChecksums;
+
+    if (!values.tailState.isEmpty())
+        tiData[ColumnTailState] = values.tailState;
+
     // item adding
     TreeItem *parentItem = add_folder(pathstr::parentFolder(filePath));
     parentItem->addChild(tiData);
@@ -168,6 +192,9 @@ QVariant TreeModel::data(const QModelIndex &curIndex, int role) const
             switch (itemFileStatus(curIndex)) {
             case FileStatus::Matched:
                 return QColor(Qt::darkGreen);
+            case FileStatus::SampleMatched:
+            case FileStatus::Unchanged:
+                return QColor(Qt::darkCyan);
             case FileStatus::Mismatched:
                 return QColor(Qt::red);
             case FileStatus::UnPermitted:
@@ -195,6 +222,34 @@ QVariant TreeModel::data(const QModelIndex &curIndex, int role) const
             return format::msecsToReadable(tiData.toLongLong());
         case ColumnSpeed:
             return format::processSpeed(tiData.toLongLong());
+        case ColumnExtraChecksums: {
+            QStringList sl;
+            const QVariantMap sums = tiData.toMap();
+            for (QVariantMap::const_iterator it = sums.constBegin(); it != sums.constEnd(); ++it)
+                sl << tools::joinStrings(it.key(), it.value().toString(), Lit::s_sepColonSpace);
+            return sl.join(QStringLiteral(u"; "));
+        }
+        case ColumnBlockChecksums: {
+            // the digests are too long to be shown
+            qint64 fileSize, blockSize;
+            if (!BlockList::parseSizes(tiData.toString(), fileSize, blockSize))
+                return QVariant();
+
+            return QString::number(BlockList::blockCount(fileSize, blockSize)) + QStringLiteral(u" × ")
+                   + format::dataSizeReadable(blockSize);
+        }
+        case ColumnChangedBlocks: {
+            qint64 fileSize, blockSize;
+            if (!BlockList::parseSizes(itemFileBlockChecksums(curIndex), fileSize, blockSize))
+                return QVariant();
+
+            return BlockList::rangesToString(BlockList::ranges(itemFileChangedBlocks(curIndex), fileSize, blockSize));
+        }
+        case ColumnTailState: {
+            // the size the state is of
+            const TailState tail = TailState::fromString(tiData.toString());
+            return tail.isValid() ? format::dataSizeReadable(tail.fileSize()) : QVariant();
+        }
         default:
             break;
         }
@@ -368,3 +423,65 @@ qint64 TreeModel::itemHashTime(const QModelIndex &fileIndex)
 
     return val.isValid() ? val.toLongLong() : -1;
 }
+
+QMap<QCryptographicHash::Algorithm, QString> TreeModel::itemFileExtraChecksums(const QModelIndex &fileIndex)
+{
+    QMap<QCryptographicHash::Algorithm, QString> res;
+    const QVariantMap sums = fileIndex.siblingAtColumn(ColumnExtraChecksums).data(RawDataRole).toMap();
+
+    for (QVariantMap::const_iterator it = sums.constBegin(); it != sums.constEnd(); ++it)
+        res[AlgoString::strToAlgo(it.key())] = it.value().toString();
+
+    return res;
+}
+
+QString TreeModel::itemFileExtraChecksum(const QModelIndex &fileIndex, QCryptographicHash::Algorithm algo)
+{
+    const QVariantMap sums = fileIndex.siblingAtColumn(ColumnExtraChecksums).data(RawDataRole).toMap();
+
+    return sums.value(AlgoString::name(algo)).toString();
+}
+
+QString TreeModel::itemFileSampleChecksum(const QModelIndex &fileIndex)
+{
+    return fileIndex.siblingAtColumn(ColumnSampleChecksum).data(RawDataRole).toString();
+}
+
+QString TreeModel::itemFileFingerprint(const QModelIndex &fileIndex)
+{
+    return fileIndex.siblingAtColumn(ColumnFingerprint).data(RawDataRole).toString();
+}
+
+QString TreeModel::itemFileBlockChecksums(const QModelIndex &fileIndex)
+{
+    return fileIndex.siblingAtColumn(ColumnBlockChecksums).data(RawDataRole).toString();
+}
+
+QList<int> TreeModel::itemFileChangedBlocks(const QModelIndex &fileIndex)
+{
+    QList<int> blocks;
+
+    for (const QVariant &block : fileIndex.siblingAtColumn(ColumnChangedBlocks).data(RawDataRole).toList())
+        blocks << block.toInt();
+
+    return blocks;
+}
+
+QString TreeModel::itemFileTailState(const QModelIndex &fileIndex)
+{
+    return fileIndex.siblingAtColumn(ColumnTailState).data(RawDataRole).toString();
+}
+
+QVariant TreeModel::extraChecksumsValue(const QMap<QCryptographicHash::Algorithm, QString> &checksums)
+{
+    if (checksums.isEmpty())
+        return QVariant();
+
+    QVariantMap sums;
+    QMap<QCryptographicHash::Algorithm, QString>::const_iterator it;
+
+    for (it = checksums.constBegin(); it != checksums.constEnd(); ++it)
+        sums[AlgoString::name(it.key())] = it.value();
+
+    return sums;
+}
@@ -29,7 +29,13 @@ public:
         ColumnChecksum,
         ColumnReChecksum,
         ColumnElapsed,
-        ColumnSpeed
+        ColumnSpeed,
+        ColumnExtraChecksums,
+        ColumnSampleChecksum,
+        ColumnFingerprint,
+        ColumnBlockChecksums,
+        ColumnChangedBlocks,
+        ColumnTailState
     };
     Q_ENUM(Column)
 
@@ -79,6 +85,26 @@ public:
     static QString itemFileReChecksum(const QModelIndex &fileIndex);
     static qint64 itemHashTime(const QModelIndex &fileIndex);
 
+    // the additional digests of a multi-digest database, {algorithm : digest}
+    static QMap<QCryptographicHash::Algorithm, QString> itemFileExtraChecksums(const QModelIndex &fileIndex);
+    static QString itemFileExtraChecksum(const QModelIndex &fileIndex, QCryptographicHash::Algorithm algo);
+    static QString itemFileSampleChecksum(const QModelIndex &fileIndex);
+
+    // "size:mtime:inode" of the file at the last match (storage::fingerprint)
+    static QString itemFileFingerprint(const QModelIndex &fileIndex);
+
+    // the stored block digests (BlockList::toString)
+    static QString itemFileBlockChecksums(const QModelIndex &fileIndex);
+
+    // the numbers of the blocks found changed by the last verification (not stored in the db)
+    static QList<int> itemFileChangedBlocks(const QModelIndex &fileIndex);
+
+    // the hash state at the end of the file (TailState::toString)
+    static QString itemFileTailState(const QModelIndex &fileIndex);
+
+    // the ColumnExtraChecksums value: {algorithm name : digest}, invalid if there are none
+    static QVariant extraChecksumsValue(const QMap<QCryptographicHash::Algorithm, QString> &checksums);
+
     template <typename T>
     static T getSiblingValue(const QModelIndex &ind, Column col) {
         const QVariant val = ind.siblingAtColumn(col).data(RawDataRole);
@@ -0,0 +1,340 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include "uringreader.h"
+
+#ifdef VER_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+struct UringReader::Ring {
+    int fd = -1;
+
+    void *sqPtr = MAP_FAILED;
+    size_t sqSize = 0;
+    void *cqPtr = MAP_FAILED;
+    size_t cqSize = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    std::vector<iovec> iovecs; // the slot buffers
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqesSize);
+        if (cqPtr != MAP_FAILED && cqPtr != sqPtr)
+            munmap(cqPtr, cqSize);
+        if (sqPtr != MAP_FAILED)
+            munmap(sqPtr, sqSize);
+        if (fd >= 0)
+            close(fd);
+    }
+}; // struct UringReader::Ring
+#endif // VER_IO_URING
+
+UringReader::UringReader(BufferPool *pool, int queueDepth, int chunkSize)
+    : m_chunkSize(chunkSize)
+{
+#ifdef VER_IO_URING
+    if (queueDepth < 1)
+        return;
+
+    m_slots.resize(queueDepth);
+
+    for (Slot &slot : m_slots)
+        slot.buffer = pool->acquire(chunkSize);
+
+    if (!setup(queueDepth)) {
+        m_slots.clear();
+        return;
+    }
+
+    registerBuffers();
+#else
+    Q_UNUSED(pool)
+    Q_UNUSED(queueDepth)
+#endif
+}
+
+UringReader::~UringReader()
+{
+#ifdef VER_IO_URING
+    // closing the ring before the buffers are returned to the pool
+    delete m_ring;
+#endif
+}
+
+bool UringReader::isValid() const
+{
+#ifdef VER_IO_URING
+    return m_ring;
+#else
+    return false;
+#endif
+}
+
+int UringReader::queueDepth() const
+{
+    return static_cast<int>(m_slots.size());
+}
+
+int UringReader::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+#ifdef VER_IO_URING
+bool UringReader::setup(int entries)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+
+    // ENOSYS: old kernel, EPERM: disabled by the sysctl or seccomp
+    if (fd < 0)
+        return false;
+
+    Ring *ring = new Ring;
+    ring->fd = fd;
+    ring->sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        ring->sqSize = ring->cqSize = qMax(ring->sqSize, ring->cqSize);
+
+    ring->sqPtr = mmap(nullptr, ring->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cqPtr = singleMmap ? ring->sqPtr
+                             : mmap(nullptr, ring->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+
+    if (ring->sqPtr == MAP_FAILED || ring->cqPtr == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        delete ring;
+        return false;
+    }
+
+    char *sq = static_cast<char*>(ring->sqPtr);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char *cq = static_cast<char*>(ring->cqPtr);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    m_ring = ring;
+    return true;
+}
+
+void UringReader::registerBuffers()
+{
+    for (const Slot &slot : m_slots)
+        m_ring->iovecs.push_back({ slot.buffer.data(), static_cast<size_t>(m_chunkSize) });
+
+    // may fail with ENOMEM when exceeding RLIMIT_MEMLOCK: the buffers are passed with each read then
+    m_fixedBuffers = (syscall(__NR_io_uring_register, m_ring->fd, IORING_REGISTER_BUFFERS,
+                              m_ring->iovecs.data(), static_cast<unsigned>(m_ring->iovecs.size())) == 0);
+}
+
+void UringReader::submitRead(int fd, int slot, qint64 offset, qint64 size)
+{
+    const unsigned tail = *m_ring->sqTail;
+    const unsigned index = tail & *m_ring->sqMask;
+
+    io_uring_sqe *sqe = &m_ring->sqes[index];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->fd = fd;
+    sqe->off = static_cast<quint64>(offset);
+    sqe->user_data = static_cast<quint64>(slot);
+
+    if (m_fixedBuffers) {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = reinterpret_cast<quint64>(m_slots[slot].buffer.data());
+        sqe->len = static_cast<unsigned>(size);
+        sqe->buf_index = static_cast<quint16>(slot);
+    }
+    else {
+        m_ring->iovecs[slot].iov_len = static_cast<size_t>(size);
+        sqe->opcode = IORING_OP_READV;
+        sqe->addr = reinterpret_cast<quint64>(&m_ring->iovecs[slot]);
+        sqe->len = 1;
+    }
+
+    m_ring->sqArray[index] = index;
+    __atomic_store_n(m_ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    Slot &sl = m_slots[slot];
+    sl.offset = offset;
+    sl.size = size;
+    sl.inFlight = true;
+    sl.completed = false;
+
+    ++m_inFlight;
+    ++m_pendingSubmit;
+}
+
+bool UringReader::submitAndWait(int waitFor)
+{
+    while (true) {
+        const unsigned flags = (waitFor > 0) ? IORING_ENTER_GETEVENTS : 0;
+        const long ret = syscall(__NR_io_uring_enter, m_ring->fd, m_pendingSubmit, waitFor, flags, nullptr, 0);
+
+        if (ret >= 0) {
+            m_pendingSubmit -= qMin(static_cast<int>(ret), m_pendingSubmit);
+            return true;
+        }
+
+        if (errno != EINTR)
+            return false;
+    }
+}
+
+bool UringReader::reap()
+{
+    unsigned head = *m_ring->cqHead;
+    const unsigned tail = __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE);
+    const bool hasCompleted = (head != tail);
+
+    for (; head != tail; ++head) {
+        const io_uring_cqe &cqe = m_ring->cqes[head & *m_ring->cqMask];
+        Slot &slot = m_slots[static_cast<size_t>(cqe.user_data)];
+
+        slot.result = cqe.res;
+        slot.inFlight = false;
+        slot.completed = true;
+        --m_inFlight;
+    }
+
+    __atomic_store_n(m_ring->cqHead, head, __ATOMIC_RELEASE);
+    return hasCompleted;
+}
+
+void UringReader::drain()
+{
+    // the kernel may still write to the buffers of the reads in flight
+    while (m_inFlight > 0) {
+        if (!submitAndWait(1))
+            break;
+        reap();
+    }
+
+    for (Slot &slot : m_slots)
+        slot.completed = false;
+}
+
+UringReader::Result UringReader::readFile(int fd, qint64 fileSize, const Consumer &consumer)
+{
+    if (!isValid())
+        return ReadError;
+
+    const int depth = queueDepth();
+    qint64 nextOffset = 0; // to submit
+    qint64 doneOffset = 0; // passed to the consumer
+    int current = 0;       // the slot of the next chunk in the file order
+
+    // the chunk N is read into the slot N % depth
+    auto submitNext = [&](int slot) {
+        if (nextOffset < fileSize) {
+            const qint64 size = qMin<qint64>(m_chunkSize, fileSize - nextOffset);
+            submitRead(fd, slot, nextOffset, size);
+            nextOffset += size;
+        }
+    };
+
+    for (int i = 0; i < depth; ++i)
+        submitNext(i);
+
+    Result result = Done;
+
+    while (doneOffset < fileSize) {
+        Slot &slot = m_slots[current];
+
+        while (!slot.completed) {
+            if (!submitAndWait(1)) {
+                result = ReadError;
+                break;
+            }
+            reap();
+        }
+
+        if (result != Done)
+            break;
+
+        slot.completed = false;
+
+        // interrupted, resubmitting
+        if (slot.result == -EINTR || slot.result == -EAGAIN) {
+            submitRead(fd, current, slot.offset, slot.size);
+            continue;
+        }
+
+        // error or unexpected end of file (truncated)
+        if (slot.result <= 0) {
+            result = ReadError;
+            break;
+        }
+
+        // short read, the rest is read synchronously
+        for (qint64 got = slot.result; got < slot.size; ) {
+            const ssize_t ret = pread(fd, slot.buffer.data() + got, static_cast<size_t>(slot.size - got), slot.offset + got);
+
+            if (ret > 0)
+                got += ret;
+            else if (ret < 0 && errno == EINTR)
+                continue;
+            else {
+                result = ReadError;
+                break;
+            }
+        }
+
+        if (result != Done)
+            break;
+
+        if (!consumer(slot.buffer.data(), slot.size)) {
+            result = Stopped;
+            break;
+        }
+
+        doneOffset += slot.size;
+        submitNext(current);
+
+        if (m_pendingSubmit > 0 && !submitAndWait(0)) {
+            result = ReadError;
+            break;
+        }
+
+        current = (current + 1) % depth;
+    }
+
+    drain();
+    return result;
+}
+#else
+UringReader::Result UringReader::readFile(int, qint64, const Consumer &)
+{
+    return ReadError;
+}
+#endif // VER_IO_URING
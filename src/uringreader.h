@@ -0,0 +1,78 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#ifndef URINGREADER_H
+#define URINGREADER_H
+
+#include <QtGlobal>
+#include <functional>
+#include <vector>
+#include "bufferpool.h"
+
+#if defined(Q_OS_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define VER_IO_URING
+#endif
+#endif
+
+/* Linux io_uring file reader: keeps up to 'queueDepth' reads of the file in flight,
+ * so fast (NVMe) devices get the queue depth they need to reach their throughput.
+ * The buffers are registered with the ring once (fixed buffers), if the memlock limit allows.
+ * The ring is reused for any number of files, the data is passed to the consumer in file order.
+ *
+ * The io_uring availability is checked at runtime (kernel version, seccomp, sysctl):
+ * if the ring can't be created, ::isValid() returns false and the regular reading should be used.
+ */
+class UringReader
+{
+public:
+    enum Result { Done, ReadError, Stopped };
+
+    // 'consumer(data, size)' returns false to stop the reading (e.g. canceled)
+    using Consumer = std::function<bool(const char *, qint64)>;
+
+    UringReader(BufferPool *pool, int queueDepth, int chunkSize);
+    ~UringReader();
+
+    bool isValid() const;
+    int queueDepth() const;
+    int chunkSize() const;
+
+    // reads the whole opened file (file descriptor) from the beginning
+    Result readFile(int fd, qint64 fileSize, const Consumer &consumer);
+
+private:
+    Q_DISABLE_COPY(UringReader)
+
+#ifdef VER_IO_URING
+    struct Ring;
+
+    bool setup(int entries);
+    void registerBuffers();
+    void submitRead(int fd, int slot, qint64 offset, qint64 size);
+    bool submitAndWait(int waitFor);
+    bool reap();       // collects the completions into the slots
+    void drain();      // waits for all reads in flight
+
+    Ring *m_ring = nullptr;
+#endif
+
+    struct Slot {
+        BufferPool::Buffer buffer;
+        qint64 offset = 0;
+        qint64 size = 0;        // requested
+        qint64 result = 0;      // bytes read or -errno
+        bool inFlight = false;
+        bool completed = false;
+    }; // struct Slot
+
+    std::vector<Slot> m_slots;
+    const int m_chunkSize;
+    int m_inFlight = 0;
+    int m_pendingSubmit = 0;
+    bool m_fixedBuffers = false;
+}; // class UringReader
+
+#endif // URINGREADER_H
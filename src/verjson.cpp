@@ -21,11 +21,18 @@ const QString VerJson::h_key_Ignored = QStringLiteral(u"Ignored");
 const QString VerJson::h_key_Included = QStringLiteral(u"Included");
 const QString VerJson::h_key_WorkDir = QStringLiteral(u"WorkDir");
 const QString VerJson::h_key_Flags = QStringLiteral(u"Flags");
+const QString VerJson::h_key_ExtraDigests = QStringLiteral(u"Extra Digests");
+const QString VerJson::h_key_FullCheck = QStringLiteral(u"Full Check");
 
 const QString VerJson::h_key_Updated = QStringLiteral(u"Updated");
 const QString VerJson::h_key_Verified = QStringLiteral(u"Verified");
 
 const QString VerJson::a_key_Unreadable = QStringLiteral(u"Unreadable files");
+const QString VerJson::a_key_ExtraChecksums = QStringLiteral(u"Extra checksums");
+const QString VerJson::a_key_SampleChecksums = QStringLiteral(u"Sample checksums");
+const QString VerJson::a_key_Fingerprints = QStringLiteral(u"Fingerprints");
+const QString VerJson::a_key_BlockChecksums = QStringLiteral(u"Block checksums");
+const QString VerJson::a_key_TailStates = QStringLiteral(u"Tail states");
 
 VerJson::VerJson(QObject *parent)
     : QObject(parent)
@@ -83,8 +90,20 @@ void VerJson::load()
 
     if (main_array.size() > 2) {
         QJsonValueRef additional = main_array[2];
-        m_unreadable = additional.isObject() ? additional.toObject().value(a_key_Unreadable).toArray()
-                                             : QJsonArray();
+
+        if (additional.isObject()) {
+            const QJsonObject addObj = additional.toObject();
+            m_unreadable = addObj.value(a_key_Unreadable).toArray();
+            const QJsonObject extra = addObj.value(a_key_ExtraChecksums).toObject();
+
+            for (QJsonObject::const_iterator it = extra.constBegin(); it != extra.constEnd(); ++it)
+                m_extra[it.key()] = it.value().toObject();
+
+            m_samples = addObj.value(a_key_SampleChecksums).toObject();
+            m_fingerprints = addObj.value(a_key_Fingerprints).toObject();
+            m_blocks = addObj.value(a_key_BlockChecksums).toObject();
+            m_tails = addObj.value(a_key_TailStates).toObject();
+        }
     }
 }
 
@@ -106,10 +125,37 @@ bool VerJson::save()
     content.append(m_header);
     content.append(m_items);
 
-    if (!m_unreadable.isEmpty()) {
-        QJsonObject unr;
-        unr[a_key_Unreadable] = m_unreadable;
-        content.append(unr);
+    // the older versions only read the unreadable list from the additional object
+    if (!m_unreadable.isEmpty() || !m_extra.isEmpty() || !m_samples.isEmpty() || !m_fingerprints.isEmpty()
+        || !m_blocks.isEmpty() || !m_tails.isEmpty())
+    {
+        QJsonObject additional;
+
+        if (!m_unreadable.isEmpty())
+            additional[a_key_Unreadable] = m_unreadable;
+
+        if (!m_extra.isEmpty()) {
+            QJsonObject extra;
+
+            for (QMap<QString, QJsonObject>::const_iterator it = m_extra.constBegin(); it != m_extra.constEnd(); ++it)
+                extra[it.key()] = it.value();
+
+            additional[a_key_ExtraChecksums] = extra;
+        }
+
+        if (!m_samples.isEmpty())
+            additional[a_key_SampleChecksums] = m_samples;
+
+        if (!m_fingerprints.isEmpty())
+            additional[a_key_Fingerprints] = m_fingerprints;
+
+        if (!m_blocks.isEmpty())
+            additional[a_key_BlockChecksums] = m_blocks;
+
+        if (!m_tails.isEmpty())
+            additional[a_key_TailStates] = m_tails;
+
+        content.append(additional);
     }
 
     const QByteArray data = QJsonDocument(content).toJson();
@@ -135,6 +181,31 @@ void VerJson::addItemUnr(const QString &file)
     m_unreadable.append(file);
 }
 
+void VerJson::addExtraItem(QCryptographicHash::Algorithm algo, const QString &file, const QString &checksum)
+{
+    m_extra[AlgoString::name(algo)][file] = checksum;
+}
+
+void VerJson::addSampleItem(const QString &file, const QString &checksum)
+{
+    m_samples[file] = checksum;
+}
+
+void VerJson::addFingerprintItem(const QString &file, const QString &fingerprint)
+{
+    m_fingerprints[file] = fingerprint;
+}
+
+void VerJson::addBlocksItem(const QString &file, const QString &blocks)
+{
+    m_blocks[file] = blocks;
+}
+
+void VerJson::addTailItem(const QString &file, const QString &tail)
+{
+    m_tails[file] = tail;
+}
+
 void VerJson::addInfo(const QString &header_key, const QString &value)
 {
     m_header[header_key] = value;
@@ -149,6 +220,9 @@ void VerJson::fillHeader()
 
     if (!m_header.contains(h_key_Algo))
         m_header[h_key_Algo] = AlgoString::name(algorithm());
+
+    if (!m_extra.isEmpty())
+        m_header[h_key_ExtraDigests] = m_extra.keys().join(Lit::s_sepCommaSpace);
 }
 
 QString VerJson::findValue(const QJsonObject &object, const QString &key) const
@@ -178,6 +252,14 @@ QCryptographicHash::Algorithm VerJson::algorithm() const
     const QString first_value = !m_items.isEmpty() ? m_items.begin().value().toString()
                                                    : QString();
 
+    // header object
+    const QString strAlgo = findValue(m_header, QStringLiteral(u"Algo"));
+
+    // the digest length is ambiguous (SHA-256 and BLAKE3), so the stored name takes precedence if it fits
+    const QCryptographicHash::Algorithm headerAlgo = AlgoString::strToAlgo(strAlgo);
+    if (headerAlgo && DigestString::isValid(first_value, headerAlgo))
+        return headerAlgo;
+
     // main list object
     DigestString dgStr(first_value);
     if (dgStr)
@@ -185,15 +267,12 @@ QCryptographicHash::Algorithm VerJson::algorithm() const
 
     qWarning() << Q_FUNC_INFO << "Algo NOT selected by first value";
 
-    // header object
-    const QString strAlgo = findValue(m_header, QStringLiteral(u"Algo"));
-
     if (strAlgo.isEmpty()) {
         qWarning() << "VerJson::algorithm >> Not found!";
         return static_cast<QCryptographicHash::Algorithm>(0);
     }
 
-    return AlgoString::strToAlgo(strAlgo);
+    return headerAlgo;
 }
 
 const QJsonObject& VerJson::items() const
@@ -205,3 +284,41 @@ const QJsonArray& VerJson::unreadableFiles() const
 {
     return m_unreadable;
 }
+
+QList<QCryptographicHash::Algorithm> VerJson::extraAlgorithms() const
+{
+    QList<QCryptographicHash::Algorithm> algos;
+
+    for (const QString &algoName : m_extra.keys()) {
+        const QCryptographicHash::Algorithm algo = AlgoString::strToAlgo(algoName);
+        if (algo && !algos.contains(algo))
+            algos << algo;
+    }
+
+    return algos;
+}
+
+QJsonObject VerJson::extraItems(QCryptographicHash::Algorithm algo) const
+{
+    return m_extra.value(AlgoString::name(algo));
+}
+
+const QJsonObject& VerJson::sampleItems() const
+{
+    return m_samples;
+}
+
+const QJsonObject& VerJson::fingerprintItems() const
+{
+    return m_fingerprints;
+}
+
+const QJsonObject& VerJson::blockItems() const
+{
+    return m_blocks;
+}
+
+const QJsonObject& VerJson::tailItems() const
+{
+    return m_tails;
+}
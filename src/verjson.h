@@ -10,6 +10,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QCryptographicHash>
+#include <QMap>
 
 class VerJson : public QObject
 {
@@ -28,6 +29,9 @@ public:
 
     void addItem(const QString &file, const QString &checksum);
     void addItemUnr(const QString &file);
+
+    // the digest of an additional algorithm (multi-digest database)
+    void addExtraItem(QCryptographicHash::Algorithm algo, const QString &file, const QString &checksum);
     void addInfo(const QString &header_key, const QString &value);
 
     const QJsonObject& items() const;
@@ -35,6 +39,26 @@ public:
     QString getInfo(const QString &header_key) const;
     QCryptographicHash::Algorithm algorithm() const;
 
+    // the additional algorithms of a multi-digest database and their { file_path : checksum } lists
+    QList<QCryptographicHash::Algorithm> extraAlgorithms() const;
+    QJsonObject extraItems(QCryptographicHash::Algorithm algo) const;
+
+    // the digests of the file samples (spot-checks), { file_path : checksum }
+    void addSampleItem(const QString &file, const QString &checksum);
+    const QJsonObject& sampleItems() const;
+
+    // the file states at the last match (storage::fingerprint), { file_path : "size:mtime:inode" }
+    void addFingerprintItem(const QString &file, const QString &fingerprint);
+    const QJsonObject& fingerprintItems() const;
+
+    // the block digests of large files (BlockList), { file_path : "block size:digests" }
+    void addBlocksItem(const QString &file, const QString &blocks);
+    const QJsonObject& blockItems() const;
+
+    // the hash states at the end of large files (TailState), { file_path : "size:digest:edges:state" }
+    void addTailItem(const QString &file, const QString &tail);
+    const QJsonObject& tailItems() const;
+
     // static keys
     static const QString h_key_Algo;
     static const QString h_key_Comment;
@@ -43,6 +67,8 @@ public:
     static const QString h_key_Included;
     static const QString h_key_WorkDir;
     static const QString h_key_Flags;
+    static const QString h_key_ExtraDigests;
+    static const QString h_key_FullCheck;
 
     static const QString h_key_Updated;
     static const QString h_key_Verified;
@@ -59,8 +85,18 @@ private:
     QJsonObject m_header;
     QJsonObject m_items;
     QJsonArray m_unreadable;
+    QMap<QString, QJsonObject> m_extra; // { algorithm name : { file_path : checksum } }
+    QJsonObject m_samples;
+    QJsonObject m_fingerprints;
+    QJsonObject m_blocks;
+    QJsonObject m_tails;
 
     static const QString a_key_Unreadable;
+    static const QString a_key_ExtraChecksums;
+    static const QString a_key_SampleChecksums;
+    static const QString a_key_Fingerprints;
+    static const QString a_key_BlockChecksums;
+    static const QString a_key_TailStates;
 }; // class VerJson
 
 #endif // VERJSON_H
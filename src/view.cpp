@@ -128,6 +128,15 @@ void View::setData(DataContainer *data)
 
     // the newly setted data has not yet been verified and does not contain ReChecksums
     hideColumn(Column::ColumnReChecksum);
+    hideColumn(Column::ColumnChangedBlocks);
+
+    if (data->m_metadata.extraAlgorithms.isEmpty())
+        hideColumn(Column::ColumnExtraChecksums);
+
+    if (!DataHelper::hasSampleDigests(data))
+        hideColumn(Column::ColumnSampleChecksum);
+
+    hideServiceColumns();
 
     QTimer::singleShot(100, this, &View::dataSetted);
 }
@@ -172,9 +181,11 @@ void View::setMismatchFiltering(const Numbers &num)
 
     if (num.contains(FileStatus::Mismatched)) {
         showAllColumns();
+        hideServiceColumns();
         setFilter(FileStatus::Mismatched);
     } else {
         hideColumn(Column::ColumnReChecksum);
+        hideColumn(Column::ColumnChangedBlocks);
     }
 }
 
@@ -368,6 +379,13 @@ void View::showAllColumns()
     }
 }
 
+void View::hideServiceColumns()
+{
+    hideColumn(Column::ColumnFingerprint);
+    hideColumn(Column::ColumnBlockChecksums);
+    hideColumn(Column::ColumnTailState);
+}
+
 void View::setDefaultColumnsWidth()
 {
     setColumnWidth(0, 450);
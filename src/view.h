@@ -80,6 +80,9 @@ private:
     void setBackgroundColor();
     void toggleColumnVisibility(int column);
     void showAllColumns();
+
+    // the fingerprints, block digests and tail states are not for reading
+    void hideServiceColumns();
     void setDefaultColumnsWidth();
     void restoreHeaderState();
     void setCurIndex(const QModelIndex &ind);
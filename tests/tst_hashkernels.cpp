@@ -0,0 +1,416 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include <QtTest>
+#include "blake3.h"
+#include "cpufeatures.h"
+#include "hashfunction.h"
+#include "sha.h"
+
+Q_DECLARE_METATYPE(CpuFeatures)
+
+// the known-answer vectors of the hashing kernels, each kernel this CPU supports and the portable ones
+class TestHashKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    // the official BLAKE3 test vectors (test_vectors.json): the input is the bytes 0..250 repeated
+    void blake3_data();
+    void blake3();
+
+    // a large input split into the subtrees hashed in parallel
+    void blake3Tree_data();
+    void blake3Tree();
+
+    // the NIST SHA-1 and SHA-256 examples (FIPS 180)
+    void sha_data();
+    void sha();
+
+    // the multi-buffer SHA-256 of many small messages, compared with QCryptographicHash
+    void sha256Multi_data();
+    void sha256Multi();
+
+    // the check value of CRC-32C (Castagnoli)
+    void crc32c_data();
+    void crc32c();
+
+    // hashing continued from a saved state, the one of another kernel as well
+    void resumed_data();
+    void resumed();
+
+private:
+    struct Engine {
+        const char *name; // the name of the kernel shown by its class (e.g. Blake3::simdName)
+        QList<bool CpuFeatures::*> features;
+    }; // struct Engine
+
+    // the ones of the 'engines' supported by this CPU
+    static QList<Engine> supported(const QList<Engine> &engines);
+    static CpuFeatures allowed(const Engine &engine);
+
+    static QList<Engine> blake3Engines();
+    static QList<Engine> shaEngines();
+    static QList<Engine> crc32cEngines();
+
+    // the input of the BLAKE3 test vectors
+    static QByteArray pattern(int length);
+    static QByteArray hexDigest(QCryptographicHash::Algorithm algo, const QByteArray &data, int threads = 1);
+};
+
+void TestHashKernels::cleanup()
+{
+    // all the detected ones
+    CpuFeatures::setAllowed(CpuFeatures::detected());
+}
+
+QList<TestHashKernels::Engine> TestHashKernels::supported(const QList<Engine> &engines)
+{
+    QList<Engine> res;
+
+    for (const Engine &engine : engines) {
+        bool isSupported = true;
+
+        for (bool CpuFeatures::*feature : engine.features)
+            isSupported = isSupported && CpuFeatures::detected().*feature;
+
+        if (isSupported)
+            res << engine;
+    }
+
+    return res;
+}
+
+CpuFeatures TestHashKernels::allowed(const Engine &engine)
+{
+    CpuFeatures res;
+
+    for (bool CpuFeatures::*feature : engine.features)
+        res.*feature = true;
+
+    return res;
+}
+
+QList<TestHashKernels::Engine> TestHashKernels::blake3Engines()
+{
+    return supported({
+        { "Portable", {} },
+        { "SSE4.1", { &CpuFeatures::sse41 } },
+        { "AVX2", { &CpuFeatures::sse41, &CpuFeatures::avx2 } },
+        { "AVX-512", { &CpuFeatures::sse41, &CpuFeatures::avx2, &CpuFeatures::avx512 } },
+    });
+}
+
+QList<TestHashKernels::Engine> TestHashKernels::shaEngines()
+{
+    return supported({
+        { "Qt", {} },
+        { "SHA-NI", { &CpuFeatures::shaNi } },
+        { "ARMv8 Crypto", { &CpuFeatures::armSha } },
+    });
+}
+
+QList<TestHashKernels::Engine> TestHashKernels::crc32cEngines()
+{
+    return supported({
+        { "Tables", {} },
+        { "SSE4.2", { &CpuFeatures::sse42 } },
+        { "ARMv8 CRC32", { &CpuFeatures::armCrc32 } },
+    });
+}
+
+QByteArray TestHashKernels::pattern(int length)
+{
+    QByteArray res(length, '\0');
+
+    for (int i = 0; i < length; ++i)
+        res[i] = static_cast<char>(i % 251);
+
+    return res;
+}
+
+QByteArray TestHashKernels::hexDigest(QCryptographicHash::Algorithm algo, const QByteArray &data, int threads)
+{
+    HashFunction func(algo);
+    func.setThreads(threads);
+    func.addData(data);
+    return func.result().toHex();
+}
+
+void TestHashKernels::blake3_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<QString>("engine");
+    QTest::addColumn<int>("length");
+    QTest::addColumn<QByteArray>("digest");
+
+    static const QList<QPair<int, QByteArray>> vectors = {
+        { 0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" },
+        { 1, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213" },
+        { 1023, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11" },
+        { 1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7" },
+        { 1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444" },
+        { 2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a" },
+        { 2049, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030" },
+        { 3072, "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2" },
+        { 3073, "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3" },
+        { 4096, "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969" },
+        { 4097, "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995" },
+        { 5120, "9cadc15fed8b5d854562b26a9536d9707cadeda9b143978f319ab34230535833" },
+        { 5121, "628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff" },
+        { 6144, "3e2e5b74e048f3add6d21faab3f83aa44d3b2278afb83b80b3c35164ebeca205" },
+        { 6145, "f1323a8631446cc50536a9f705ee5cb619424d46887f3c376c695b70e0f0507f" },
+        { 7168, "61da957ec2499a95d6b8023e2b0e604ec7f6b50e80a9678b89d2628e99ada77a" },
+        { 7169, "a003fc7a51754a9b3c7fae0367ab3d782dccf28855a03d435f8cfe74605e7817" },
+        { 8192, "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63" },
+        { 8193, "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b" },
+        { 16384, "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4" },
+        { 31744, "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47" },
+        { 102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085" },
+    };
+
+    for (const Engine &engine : blake3Engines()) {
+        for (const QPair<int, QByteArray> &vec : vectors) {
+            QTest::addRow("BLAKE3 %s %d", engine.name, vec.first)
+                << allowed(engine) << QString(engine.name) << vec.first << vec.second;
+        }
+    }
+}
+
+void TestHashKernels::blake3()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(QString, engine);
+    QFETCH(int, length);
+    QFETCH(QByteArray, digest);
+
+    CpuFeatures::setAllowed(features);
+    QCOMPARE(QString(Blake3::simdName()), engine);
+    QCOMPARE(hexDigest(Algo::Blake3, pattern(length)), digest);
+}
+
+void TestHashKernels::blake3Tree_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<int>("threads");
+
+    for (const Engine &engine : blake3Engines()) {
+        QTest::addRow("BLAKE3 %s, 1 thread", engine.name) << allowed(engine) << 1;
+        QTest::addRow("BLAKE3 %s, 4 threads", engine.name) << allowed(engine) << 4;
+    }
+}
+
+void TestHashKernels::blake3Tree()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(int, threads);
+
+    CpuFeatures::setAllowed(features);
+
+    // 1 MiB + 1025 bytes: 1026 chunks, the subtree of the first 1024 ones is split between the threads
+    QCOMPARE(hexDigest(Algo::Blake3, pattern(1024 * 1024 + 1025), threads),
+             QByteArray("860f19b5fefff01454de342be87a20059449529116a20fb22a21da665aafa071"));
+}
+
+void TestHashKernels::sha_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<QString>("engine");
+    QTest::addColumn<int>("algo");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("digest");
+
+    const QByteArray abc("abc");
+    const QByteArray msg448("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    const QByteArray million(1000000, 'a');
+
+    for (const Engine &engine : shaEngines()) {
+        const CpuFeatures features = allowed(engine);
+
+        QTest::addRow("%s SHA-1 abc", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha1)
+            << abc << QByteArray("a9993e364706816aba3e25717850c26c9cd0d89d");
+        QTest::addRow("%s SHA-1 empty", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha1)
+            << QByteArray() << QByteArray("da39a3ee5e6b4b0d3255bfef95601890afd80709");
+        QTest::addRow("%s SHA-1 448 bits", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha1)
+            << msg448 << QByteArray("84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+        QTest::addRow("%s SHA-1 million a", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha1)
+            << million << QByteArray("34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+        QTest::addRow("%s SHA-256 abc", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha256)
+            << abc << QByteArray("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        QTest::addRow("%s SHA-256 empty", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha256)
+            << QByteArray() << QByteArray("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        QTest::addRow("%s SHA-256 448 bits", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha256)
+            << msg448 << QByteArray("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        QTest::addRow("%s SHA-256 million a", engine.name) << features << QString(engine.name) << int(QCryptographicHash::Sha256)
+            << million << QByteArray("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+}
+
+void TestHashKernels::sha()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(QString, engine);
+    QFETCH(int, algo);
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, digest);
+
+    const QCryptographicHash::Algorithm sha_algo = static_cast<QCryptographicHash::Algorithm>(algo);
+
+    CpuFeatures::setAllowed(features);
+    QCOMPARE(HashFunction::engineName(sha_algo), engine);
+    QCOMPARE(hexDigest(sha_algo, data), digest);
+}
+
+void TestHashKernels::sha256Multi_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<int>("lanes");
+
+    const QList<Engine> engines = supported({
+        { "SSE4.1", { &CpuFeatures::sse41 } },
+        { "AVX2", { &CpuFeatures::sse41, &CpuFeatures::avx2 } },
+    });
+
+    for (const Engine &engine : engines)
+        QTest::newRow(engine.name) << allowed(engine) << (engine.features.size() == 1 ? 4 : 8);
+
+    if (engines.isEmpty())
+        QTest::newRow("none") << CpuFeatures() << 0;
+}
+
+void TestHashKernels::sha256Multi()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(int, lanes);
+
+    if (lanes == 0)
+        QSKIP("No multi-buffer SHA-256 on this CPU");
+
+    CpuFeatures::setAllowed(features);
+    QCOMPARE(Sha::multiLanes(), lanes);
+
+    // all the lengths around the block and padding boundaries; the lanes take the messages unevenly
+    QList<QByteArray> messages;
+    for (int length = 0; length <= 300; ++length)
+        messages << pattern(length);
+
+    std::vector<const uint8_t*> data;
+    std::vector<size_t> lengths;
+
+    for (const QByteArray &message : std::as_const(messages)) {
+        data.push_back(reinterpret_cast<const uint8_t*>(message.constData()));
+        lengths.push_back(static_cast<size_t>(message.size()));
+    }
+
+    std::vector<uint8_t> digests(messages.size() * 32);
+    Sha::sha256Multi(data.data(), lengths.data(), lengths.size(), digests.data());
+
+    for (int i = 0; i < messages.size(); ++i) {
+        const QByteArray digest(reinterpret_cast<const char*>(digests.data() + i * 32), 32);
+        QCOMPARE(digest.toHex(), QCryptographicHash::hash(messages.at(i), QCryptographicHash::Sha256).toHex());
+    }
+}
+
+void TestHashKernels::crc32c_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<QString>("engine");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("digest");
+
+    for (const Engine &engine : crc32cEngines()) {
+        const CpuFeatures features = allowed(engine);
+
+        QTest::addRow("%s check", engine.name) << features << QString(engine.name)
+            << QByteArray("123456789") << QByteArray("e3069283");
+        QTest::addRow("%s empty", engine.name) << features << QString(engine.name)
+            << QByteArray() << QByteArray("00000000");
+
+        // long enough for the interleaved streams of the hardware kernels
+        QTest::addRow("%s 100000", engine.name) << features << QString(engine.name)
+            << pattern(100000) << QByteArray("7247f66b");
+    }
+}
+
+void TestHashKernels::crc32c()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(QString, engine);
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, digest);
+
+    CpuFeatures::setAllowed(features);
+    QCOMPARE(HashFunction::engineName(Algo::Crc32c), engine);
+    QCOMPARE(hexDigest(Algo::Crc32c, data), digest);
+}
+
+void TestHashKernels::resumed_data()
+{
+    QTest::addColumn<CpuFeatures>("features");
+    QTest::addColumn<int>("algo");
+    QTest::addColumn<QByteArray>("digest");
+
+    // of the pattern(102400)
+    for (const Engine &engine : blake3Engines()) {
+        QTest::addRow("BLAKE3 %s", engine.name) << allowed(engine) << int(Algo::Blake3)
+            << QByteArray("bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085");
+    }
+
+    // the SHA states are saved by the hardware kernels only
+    for (const Engine &engine : shaEngines()) {
+        if (engine.features.isEmpty())
+            continue;
+
+        QTest::addRow("%s SHA-1", engine.name) << allowed(engine) << int(QCryptographicHash::Sha1)
+            << QCryptographicHash::hash(pattern(102400), QCryptographicHash::Sha1).toHex();
+        QTest::addRow("%s SHA-256", engine.name) << allowed(engine) << int(QCryptographicHash::Sha256)
+            << QCryptographicHash::hash(pattern(102400), QCryptographicHash::Sha256).toHex();
+    }
+
+    for (const Engine &engine : crc32cEngines())
+        QTest::addRow("CRC-32C %s", engine.name) << allowed(engine) << int(Algo::Crc32c) << QByteArray("7957da17");
+}
+
+void TestHashKernels::resumed()
+{
+    QFETCH(CpuFeatures, features);
+    QFETCH(int, algo);
+    QFETCH(QByteArray, digest);
+
+    const QCryptographicHash::Algorithm hash_algo = static_cast<QCryptographicHash::Algorithm>(algo);
+    const QByteArray data = pattern(102400);
+    const int split = 40001; // not at a block or chunk boundary
+
+    CpuFeatures::setAllowed(features);
+
+    HashFunction first(hash_algo);
+    first.addData(data.left(split));
+    const QByteArray state = first.state();
+    QVERIFY(!state.isEmpty());
+
+    // by the same kernel
+    HashFunction same(hash_algo);
+    QVERIFY(same.setState(state));
+    same.addData(data.mid(split));
+    QCOMPARE(same.result().toHex(), digest);
+
+    // by the ones of this CPU
+    CpuFeatures::setAllowed(CpuFeatures::detected());
+
+    HashFunction other(hash_algo);
+    QVERIFY(other.setState(state));
+    other.addData(data.mid(split));
+    QCOMPARE(other.result().toHex(), digest);
+
+    // a state of another algorithm is not taken
+    HashFunction wrong(hash_algo == Algo::Crc32c ? Algo::Blake3 : Algo::Crc32c);
+    QVERIFY(!wrong.setState(state));
+}
+
+QTEST_MAIN(TestHashKernels)
+#include "tst_hashkernels.moc"
@@ -0,0 +1,108 @@
+/*
+ * This file is part of Veretino,
+ * licensed under the GNU GPLv3.
+ * https://github.com/artemvlas/veretino
+*/
+#include <QtTest>
+#include <QTemporaryDir>
+#include "manager.h"
+#include "treemodeliterator.h"
+#include "tools.h"
+
+// the db is updated with the checksums of the files changed by their size (DbMod::DM_UpdateMismatches)
+class TestUpdateMismatches : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // an outdated digest file next to the changed one (file.txt.sha256) is not imported instead of its new checksum
+    void staleDigestFileIgnored();
+
+private:
+    static void writeFile(const QString &filePath, const QByteArray &data);
+    static QString sha256(const QByteArray &data);
+    static QModelIndex findFile(const QAbstractItemModel *model, const QString &relPath);
+};
+
+void TestUpdateMismatches::initTestCase()
+{
+    // no settings of the user are touched
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestUpdateMismatches::writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    QCOMPARE(file.write(data), data.size());
+}
+
+QString TestUpdateMismatches::sha256(const QByteArray &data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+QModelIndex TestUpdateMismatches::findFile(const QAbstractItemModel *model, const QString &relPath)
+{
+    for (TreeModelIterator iter(model); iter.hasNext();) {
+        if (iter.nextFile().path() == relPath)
+            return iter.index();
+    }
+
+    return QModelIndex();
+}
+
+void TestUpdateMismatches::staleDigestFileIgnored()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString filePath = dir.filePath("file.txt");
+    const QByteArray original("the original contents\n");
+    const QByteArray changed("the contents changed, along with the size\n");
+    writeFile(filePath, original);
+
+    Settings settings;
+    settings.m_importSumsWhenItemAdding = true;
+    settings.hashing_checkpoints = false;
+    settings.instantSaving = false;
+    settings.detectMoved = false;
+
+    Manager manager(&settings);
+
+    MetaData meta;
+    meta.algorithm = QCryptographicHash::Sha256;
+    meta.workDir = dir.path();
+    meta.dbFilePath = dir.filePath("checksums.ver.json");
+
+    manager.addTaskWithState(State::StartSilently, &Manager::processFolderSha, meta, false);
+    manager.runTasks();
+    QVERIFY(QFileInfo::exists(meta.dbFilePath));
+
+    // the file is changed, the digest file next to it holds some other checksum
+    writeFile(filePath, changed);
+    writeFile(paths::digestFilePath(filePath, QCryptographicHash::Sha256),
+              sha256("stale").toLatin1() + "  file.txt\n");
+
+    manager.addTaskWithState(State::StartSilently, &Manager::createDataModel, meta.dbFilePath, QString());
+    manager.addTaskWithState(State::StartSilently, &Manager::verifyFolderItem, QModelIndex(), FileStatus::CombNotChecked);
+    manager.runTasks();
+
+    const QAbstractItemModel *model = manager.m_dataMaintainer->m_data->m_model;
+    QModelIndex fileIndex = findFile(model, "file.txt");
+    QVERIFY(fileIndex.isValid());
+    QCOMPARE(TreeModel::itemFileStatus(fileIndex), FileStatus::Mismatched);
+
+    manager.addTaskWithState(State::StartSilently, &Manager::updateDatabase, DbMod::DM_UpdateMismatches);
+    manager.runTasks();
+
+    fileIndex = findFile(model, "file.txt");
+    QVERIFY(fileIndex.isValid());
+    QCOMPARE(TreeModel::itemFileStatus(fileIndex), FileStatus::Updated);
+    QCOMPARE(TreeModel::itemFileChecksum(fileIndex), sha256(changed));
+}
+
+QTEST_MAIN(TestUpdateMismatches)
+#include "tst_updatemismatches.moc"